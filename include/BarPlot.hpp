@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "BarPlotBase.hpp"
+#include "DataArray.hpp"
 #include "svg.hpp"
 #include "utility.hpp"
 
@@ -64,6 +65,40 @@ public:
   void Plot(const std::vector<Real> &y_data, const Color &color);
   void Plot(const std::vector<Real> &y_data);
 
+  /** Plot values of any numeric type. Bar heights are converted to Real once
+   * when they are plotted. */
+  template <DataElement T, DataElement U>
+  void Plot(const std::vector<T> &x_data, const std::vector<U> &y_data,
+            const Color &color) {
+    PlotNumeric(adaptor::Real(x_data), adaptor::Real(y_data), color);
+  }
+
+  template <DataElement T, DataElement U>
+  void Plot(const std::vector<T> &x_data, const std::vector<U> &y_data) {
+    Plot(x_data, y_data, m_color_selector.NextColor());
+  }
+
+  template <DataElement T>
+  void Plot(const std::vector<std::string> &x_data,
+            const std::vector<T> &y_data, const Color &color) {
+    PlotCategorical(x_data, adaptor::Real(y_data), color);
+  }
+
+  template <DataElement T>
+  void Plot(const std::vector<std::string> &x_data,
+            const std::vector<T> &y_data) {
+    Plot(x_data, y_data, m_color_selector.NextColor());
+  }
+
+  template <DataElement T>
+  void Plot(const std::vector<T> &y_data, const Color &color) {
+    PlotValues(adaptor::Real(y_data), color);
+  }
+
+  template <DataElement T> void Plot(const std::vector<T> &y_data) {
+    Plot(y_data, m_color_selector.NextColor());
+  }
+
   void SetXData(const std::vector<Real> &x_data);
   void SetXData(const std::vector<std::string> &x_data);
 
@@ -90,6 +125,12 @@ public:
 
 protected:
   ColorSelector m_color_selector;
+
+  void PlotNumeric(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+                   const Color &color);
+  void PlotCategorical(const std::vector<std::string> &x_data,
+                       std::vector<Real> &&y_data, const Color &color);
+  void PlotValues(std::vector<Real> &&y_data, const Color &color);
 };
 
 } // namespace plotcpp
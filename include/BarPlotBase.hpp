@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "Figure.hpp"
+#include "transform.hpp"
 #include "utility.hpp"
 
 namespace plotcpp {
@@ -68,6 +69,9 @@ protected:
 
   void ClearData();
 
+  /** Mark the layers that depend on the data series to be drawn again */
+  void InvalidateData();
+
   enum class DataType {
     NUMERIC,
     CATEGORICAL,
@@ -109,6 +113,7 @@ protected:
   static constexpr float BAR_FRAME_X_MARGIN_REL = 0.05f;
   static constexpr float DEFAULT_BAR_WIDTH_REL = 0.65f;
   static const std::string FRAME_RECT_CLIP_PATH_ID;
+  static const std::string FRAME_RECT_CLIP_PATH_URL;
 
   float m_bar_width_rel = DEFAULT_BAR_WIDTH_REL;
 
@@ -127,7 +132,8 @@ protected:
 
   static constexpr float LEGEND_MARGIN = 5.0f;
 
-  float TranslateToFrame(Real y) const;
+  /** Affine map of y values to coordinates relative to the frame */
+  transform::Affine FrameTransformY() const;
 
   float m_zoom_y = 1.0f;
   float m_bar_top_y;
@@ -0,0 +1,153 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_DATA_ARRAY_HPP_
+#define _PLOTCPP_INCLUDE_DATA_ARRAY_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "utility.hpp"
+
+namespace plotcpp {
+
+/** Numeric types that can be plotted without converting them first */
+template <typename T>
+concept DataElement =
+    std::is_same_v<T, float> || std::is_same_v<T, double> ||
+    std::is_same_v<T, long double> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, short> ||
+    std::is_same_v<T, unsigned short> || std::is_same_v<T, int> ||
+    std::is_same_v<T, unsigned int> || std::is_same_v<T, long> ||
+    std::is_same_v<T, unsigned long> || std::is_same_v<T, long long> ||
+    std::is_same_v<T, unsigned long long>;
+
+/**
+ * @brief Array of values that is either owned by a figure or borrowed from
+ * the caller. Borrowed values are not copied, so they must outlive the
+ * array.
+ *
+ * Values keep their native type and are converted to Real when they are
+ * read, by visiting a view of the native type.
+ */
+class DataArray {
+public:
+  using View =
+      std::variant<std::span<const float>, std::span<const double>,
+                   std::span<const long double>, std::span<const signed char>,
+                   std::span<const unsigned char>, std::span<const short>,
+                   std::span<const unsigned short>, std::span<const int>,
+                   std::span<const unsigned int>, std::span<const long>,
+                   std::span<const unsigned long>, std::span<const long long>,
+                   std::span<const unsigned long long>>;
+
+  DataArray() = default;
+
+  /** Take ownership of the values */
+  template <DataElement T> explicit DataArray(std::vector<T> &&values) {
+    auto owned = std::make_shared<std::vector<T>>(std::move(values));
+    m_view = std::span<const T>(*owned);
+    m_owned = std::move(owned);
+  }
+
+  /** Borrow the values */
+  template <DataElement T>
+  explicit DataArray(std::span<const T> values) : m_view(values) {}
+
+  DataArray(const DataArray &other) : m_view(other.m_view) {
+    if (other.IsOwned()) {
+      std::visit(
+          [this](auto view) {
+            using T = typename decltype(view)::element_type;
+            auto owned = std::make_shared<std::vector<std::remove_const_t<T>>>(
+                view.begin(), view.end());
+            m_view = std::span<T>(*owned);
+            m_owned = std::move(owned);
+          },
+          other.m_view);
+    }
+  }
+
+  DataArray(DataArray &&other) noexcept = default;
+
+  DataArray &operator=(DataArray other) noexcept {
+    m_owned = std::move(other.m_owned);
+    m_view = other.m_view;
+    return *this;
+  }
+
+  /** Returns true if the values are owned by the array */
+  bool IsOwned() const { return m_owned != nullptr; }
+
+  /** Returns the number of values */
+  std::size_t size() const {
+    return std::visit([](auto view) { return view.size(); }, m_view);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /** Returns a pointer to the first value in its native type */
+  const void *data() const {
+    return std::visit([](auto view) -> const void * { return view.data(); },
+                      m_view);
+  }
+
+  /**
+   * @brief Call a function with a std::span of the values in their native
+   * type. The function is instantiated for every type, so that values can be
+   * converted in the same loop that processes them.
+   */
+  template <typename F> decltype(auto) Visit(F &&function) const {
+    return std::visit(std::forward<F>(function), m_view);
+  }
+
+  /** Returns a copy of the values converted to Real */
+  std::vector<Real> ToReal() const {
+    return Visit([](auto view) {
+      std::vector<Real> values(view.size());
+      for (std::size_t i = 0; i < view.size(); ++i) {
+        values[i] = static_cast<Real>(view[i]);
+      }
+      return values;
+    });
+  }
+
+  /** Returns an array that owns a copy of the values converted to T */
+  template <DataElement T> DataArray Convert() const {
+    return Visit([](auto view) {
+      std::vector<T> values(view.size());
+      for (std::size_t i = 0; i < view.size(); ++i) {
+        values[i] = static_cast<T>(view[i]);
+      }
+      return DataArray(std::move(values));
+    });
+  }
+
+private:
+  std::shared_ptr<const void> m_owned;
+  View m_view = std::span<const Real>();
+};
+
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_DATA_ARRAY_HPP_
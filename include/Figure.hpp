@@ -19,8 +19,13 @@
 #ifndef _PLOTCPP_INCLUDE_FIGURE_HPP_
 #define _PLOTCPP_INCLUDE_FIGURE_HPP_
 
+#include <bitset>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "svg.hpp"
 #include "utility.hpp"
@@ -29,6 +34,21 @@ namespace plotcpp {
 
 class Figure {
 public:
+  /**
+   * The layers of a figure, from bottom to top. Each layer is kept in the
+   * document between builds and drawn again only if a setter invalidated it.
+   */
+  enum class Layer {
+    BACKGROUND,
+    TITLE,
+    FRAME,
+    LABELS,
+    DATA,
+    LEGEND,
+  };
+
+  static constexpr std::size_t NUM_LAYERS = 6;
+
   virtual ~Figure() = default;
 
   /**
@@ -40,6 +60,12 @@ public:
   /** @brief Clear the figure */
   virtual void Clear() = 0;
 
+  /**
+   * @brief Returns the layers that were drawn again by the last Build, from
+   * bottom to top.
+   */
+  std::vector<Layer> GetRebuiltLayers() const;
+
   /**
    * @brief Render the figure on a window (blocking).
    */
@@ -51,7 +77,8 @@ public:
   [[nodiscard]] std::thread ShowThread() const;
 
   /**
-   * @brief Render and save the figure to a file.
+   * @brief Render and save the figure to a file. The format is chosen by the
+   * extension: svg, png, or gzip-compressed svg for svgz and svg.gz.
    *
    * @param filepath Path to a file to save the figure.
    */
@@ -63,9 +90,68 @@ public:
    */
   std::string GetSVGText() const;
 
+  /**
+   * @brief Write the SVG representation of this Figure in chunks, without
+   * building the whole text in memory.
+   * This function must be called after Build
+   *
+   * @param writer Function called with every chunk of text in order
+   */
+  void WriteSVG(const svg::Document::Writer &writer) const;
+
+  /**
+   * @brief Write the SVG representation of this Figure to an output stream.
+   * This function must be called after Build
+   */
+  void WriteSVG(std::ostream &out) const;
+
+  /**
+   * @brief Write the SVG representation of this Figure to a C file stream.
+   * This function must be called after Build
+   */
+  void WriteSVG(std::FILE *file) const;
+
+  /**
+   * @brief Write the SVG representation of this Figure to a file descriptor.
+   * Nothing more is written after a write error.
+   * This function must be called after Build
+   *
+   * @return false if a write failed, with errno set by write
+   */
+  bool WriteSVG(int fd) const;
+
   /** @brief Return the svg document */
   svg::Document &GetSVGDocument();
 
+  /**
+   * @brief Select how the SVG document of this figure is generated.
+   *
+   * The DOM backend builds a libxml2 tree. The STREAM backend serializes every
+   * element as soon as it is drawn, which is much faster and lighter for
+   * figures with many elements. Changing the backend clears the document, so
+   * the figure must be built again.
+   *
+   * @param backend SVG document backend
+   */
+  void SetSVGBackend(svg::Document::Backend backend);
+
+  /**
+   * @brief Set the maximum number of decimals of the numbers in the SVG
+   * document. Sub-pixel precision is rarely needed, so a small number of
+   * decimals produces much smaller documents.
+   *
+   * @param precision Number of decimals, or svg::SHORTEST_PRECISION
+   */
+  void SetSVGPrecision(int precision);
+
+  /**
+   * @brief Write the SVG document without indentation or line breaks between
+   * elements. Takes effect on the next Build.
+   *
+   * @param compact Compact mode
+   */
+  void SetSVGCompact(bool compact);
+
   /**
    * @brief Set figure title.
    *
@@ -114,13 +200,38 @@ protected:
   /** String containing an XML description of an SVG image */
   svg::Document m_svg;
 
-  explicit Figure() = default;
+  /** Layers that must be drawn again on the next Build */
+  std::bitset<NUM_LAYERS> m_invalid_layers;
+  /** Layers drawn again by the last Build */
+  std::bitset<NUM_LAYERS> m_rebuilt_layers;
+
+  explicit Figure();
+
+  /** Mark a layer to be drawn again on the next Build */
+  void Invalidate(Layer layer);
+
+  /** Mark all layers to be drawn again on the next Build */
+  void InvalidateAll();
+
+  /**
+   * @brief Prepare a layer to be drawn if it is invalid: its elements are
+   * removed and new elements are drawn into it.
+   *
+   * @return true if the layer must be drawn, false if it is up to date
+   */
+  bool BeginLayer(Layer layer);
 
 private:
   /**
    * @brief Save plot to svg format
    */
   void SaveSVG(const std::string &filepath) const;
+
+  /**
+   * @brief Save plot to gzip-compressed svg format. The document is deflated
+   * as it is serialized.
+   */
+  void SaveSVGZ(const std::string &filepath) const;
 };
 
 } // namespace plotcpp
@@ -23,7 +23,6 @@
 #include <string>
 
 #include "Figure.hpp"
-#include "libxml/tree.h"
 #include "svg.hpp"
 
 namespace plotcpp {
@@ -82,12 +81,7 @@ public:
 
         figure->SetSize(subplot_width, subplot_height);
         figure->Build();
-        xmlDocPtr original_doc = figure->GetSVGDocument().GetDoc();
-        xmlNodePtr original_root = xmlDocGetRootElement(original_doc);
-        xmlNodePtr cloned_root = xmlCopyNode(original_root, 1);
-        svg::SetAttribute(cloned_root, "x", std::to_string(x));
-        svg::SetAttribute(cloned_root, "y", std::to_string(y));
-        m_svg.Append(cloned_root);
+        m_svg.AppendDocument(figure->GetSVGDocument(), x, y);
       }
     }
   }
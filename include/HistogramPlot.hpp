@@ -19,9 +19,11 @@
 #ifndef _PLOTCPP_INCLUDE_HISTOGRAM_PLOT_HPP_
 #define _PLOTCPP_INCLUDE_HISTOGRAM_PLOT_HPP_
 
+#include <span>
 #include <vector>
 
 #include "BarPlotBase.hpp"
+#include "DataArray.hpp"
 #include "Figure.hpp"
 #include "utility.hpp"
 
@@ -52,11 +54,40 @@ public:
    */
   void Plot(const std::vector<Real> &values, unsigned int num_bins);
 
+  /**
+   * @brief Plot a histogram of a sequence of values of any numeric type. The
+   * values are counted in their native type without copying them.
+   *
+   * @param values Vector of values
+   * @param num_bins Number of bins
+   * @param color Bar colour
+   */
+  template <DataElement T>
+  void Plot(const std::vector<T> &values, unsigned int num_bins,
+            const Color &color) {
+    PlotValues(DataArray(std::span<const T>(values)), num_bins, color);
+  }
+
+  /**
+   * @brief Plot a histogram of a sequence of values of any numeric type. The
+   * values are counted in their native type without copying them.
+   *
+   * @param values Vector of values
+   * @param num_bins Number of bins
+   */
+  template <DataElement T>
+  void Plot(const std::vector<T> &values, unsigned int num_bins) {
+    Plot(values, num_bins, DEFAULT_COLOR);
+  }
+
 protected:
-  std::vector<Real> CalculateIntervals(const std::vector<Real> &values,
+  void PlotValues(const DataArray &values, unsigned int num_bins,
+                  const Color &color);
+
+  std::vector<Real> CalculateIntervals(const DataArray &values,
                                        unsigned int num_bins);
   std::vector<Real> CalculateBins(const std::vector<Real> &intervals);
-  std::vector<Real> CalculateHistogram(const std::vector<Real> &values,
+  std::vector<Real> CalculateHistogram(const DataArray &values,
                                        const std::vector<Real> &intervals);
 
   static constexpr Color DEFAULT_COLOR{0x332288};
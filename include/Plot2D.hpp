@@ -22,13 +22,21 @@
 #include <algorithm>
 #include <array>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "clipping.hpp"
+#include "DataArray.hpp"
 #include "Figure.hpp"
+#include "StreamBuffer.hpp"
+#include "ThreadPool.hpp"
+#include "transform.hpp"
 #include "utility.hpp"
 
 namespace plotcpp {
@@ -38,6 +46,80 @@ namespace plotcpp {
  */
 class Plot2D : public Figure {
 public:
+  /** How the markers of scatter plots are drawn */
+  enum class ScatterMode {
+    /** One <circle> per point */
+    CIRCLES,
+    /** One <use> per point referencing a marker defined once per series */
+    SYMBOLS,
+    /** A single path per series made of zero-length round-capped segments */
+    PATH,
+    /** A single image per series with the number of points in each px of the
+     * frame mapped to a colormap. Suited to series with millions of points. */
+    DENSITY,
+  };
+
+  /** Algorithms that simplify line series before they are drawn */
+  enum class Simplification {
+    /** All points are drawn */
+    NONE,
+    /** Ramer-Douglas-Peucker: removes the points closer than the tolerance to
+     * the simplified line */
+    DOUGLAS_PEUCKER,
+    /** Visvalingam-Whyatt: removes the points that form triangles with their
+     * neighbours smaller than the square of the tolerance */
+    VISVALINGAM,
+  };
+
+  /** Default simplification tolerance in px */
+  static constexpr float DEFAULT_SIMPLIFICATION_TOLERANCE = 0.25f;
+
+  /** Algorithms that decimate dense line series before they are drawn */
+  enum class Decimation {
+    /** All points are drawn */
+    NONE,
+    /** Only the first, last, minimum and maximum points of each pixel column
+     * are drawn. The rendered line is the same as with all points. */
+    M4,
+  };
+
+  /** Types that the values of numeric series are stored as */
+  enum class StoragePrecision {
+    /** Values keep the type they were plotted with */
+    NATIVE,
+    /** Values are stored as float. Suited to large series, since coordinates
+     * are drawn in float precision anyway. */
+    FLOAT32,
+    /** Values are stored as double */
+    FLOAT64,
+  };
+
+  /** Default number of points per px above which series are decimated */
+  static constexpr float DEFAULT_DECIMATION_THRESHOLD = 4.0f;
+
+  /** Default number of cells per px in which overdrawn markers are found */
+  static constexpr std::size_t DEFAULT_OVERDRAW_SUBPIXELS = 4;
+
+  /** Statistics of the last time the data series were drawn */
+  struct DataStats {
+    /** Number of line vertices removed by simplification */
+    std::size_t removed_vertices = 0;
+    /** Number of line vertices removed by decimation */
+    std::size_t decimated_vertices = 0;
+    /** Number of line vertices removed by downsampling */
+    std::size_t downsampled_vertices = 0;
+    /** Number of line vertices and scatter markers outside the frame */
+    std::size_t culled_vertices = 0;
+    /** Number of scatter markers covered by an earlier marker */
+    std::size_t overdrawn_markers = 0;
+  };
+
+  /**
+   * Handle of a series added with PlotStream. It refers to the stream itself,
+   * so it does not select another series once the series are replaced.
+   */
+  using SeriesHandle = std::weak_ptr<StreamBuffer>;
+
   Plot2D();
   virtual ~Plot2D() = default;
 
@@ -69,6 +151,182 @@ public:
   void Plot(const std::vector<Real> &x_data, const std::vector<Real> &y_data,
             const float stroke_width = 2, const std::string &dash_array = {});
 
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length. The sequences are moved into the figure.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void Plot(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {});
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length. The sequences are moved into the figure.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void Plot(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+            const float stroke_width = 2, const std::string &dash_array = {});
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length. The sequences are borrowed, not copied: they must
+   * remain valid and unchanged while the plot is in the figure and the
+   * figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void Plot(std::span<const Real> x_data, std::span<const Real> y_data,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {});
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length. The sequences are borrowed, not copied: they must
+   * remain valid and unchanged while the plot is in the figure and the
+   * figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void Plot(std::span<const Real> x_data, std::span<const Real> y_data,
+            const float stroke_width = 2, const std::string &dash_array = {});
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The values are stored in
+   * their native type and converted when the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(const std::vector<T> &x_data, const std::vector<U> &y_data,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {}) {
+    Plot(std::vector<T>(x_data), std::vector<U>(y_data), color, stroke_width,
+         dash_array);
+  }
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The values are stored in
+   * their native type and converted when the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(const std::vector<T> &x_data, const std::vector<U> &y_data,
+            const float stroke_width = 2, const std::string &dash_array = {}) {
+    Plot(x_data, y_data, m_color_selector.NextColor(), stroke_width,
+         dash_array);
+  }
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The sequences are moved into
+   * the figure in their native type.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(std::vector<T> &&x_data, std::vector<U> &&y_data,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {}) {
+    PlotNumeric(DataArray(std::move(x_data)), DataArray(std::move(y_data)),
+                color, stroke_width, dash_array);
+  }
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The sequences are moved into
+   * the figure in their native type.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(std::vector<T> &&x_data, std::vector<U> &&y_data,
+            const float stroke_width = 2, const std::string &dash_array = {}) {
+    Plot(std::move(x_data), std::move(y_data), m_color_selector.NextColor(),
+         stroke_width, dash_array);
+  }
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The sequences are borrowed,
+   * not copied: they must remain valid and unchanged while the plot is in the
+   * figure and the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(std::span<const T> x_data, std::span<const U> y_data,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {}) {
+    PlotNumeric(DataArray(x_data), DataArray(y_data), color, stroke_width,
+                dash_array);
+  }
+
+  /**
+   * @brief Add a plot consisting of an x-axis sequence and a y-axis sequence
+   * of the same length and of any numeric type. The sequences are borrowed,
+   * not copied: they must remain valid and unchanged while the plot is in the
+   * figure and the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <DataElement T, DataElement U>
+  void Plot(std::span<const T> x_data, std::span<const U> y_data,
+            const float stroke_width = 2, const std::string &dash_array = {}) {
+    Plot(x_data, y_data, m_color_selector.NextColor(), stroke_width,
+         dash_array);
+  }
+
   /**
    * @brief Add a plot consisting of one y-axis sequence of size N. The x-axis
    * sequence will be automatically deduced as a 1-increment sequence from
@@ -125,6 +383,52 @@ public:
             const std::function<Real(Real)> &function,
             const float stroke_width = 2, const std::string &dash_array = {});
 
+  /**
+   * @brief Add a plot of a function y=function(x) over an interval of x. The
+   * function is kept and sampled adaptively when the figure is built, over
+   * the visible part of the interval and at the resolution of the frame, so
+   * that smooth stretches take few evaluations and curves and
+   * discontinuities are refined. The samples are kept until the x range or
+   * the size of the figure changes.
+   *
+   * @param x_range Interval of x values
+   * @param function A function such that y=function(x)
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <typename F>
+    requires std::is_invocable_r_v<Real, F &, Real>
+  void Plot(const ranges::Interval<Real> &x_range, F &&function,
+            const Color &color, const float stroke_width = 2,
+            const std::string &dash_array = {}) {
+    if (!(x_range.first < x_range.second)) {
+      return;
+    }
+
+    AddGenerator(std::function<Real(Real)>(std::forward<F>(function)),
+                 x_range, color, stroke_width, dash_array);
+  }
+
+  /**
+   * @brief Add a plot of a function y=function(x) over an interval of x. The
+   * function is sampled adaptively at the resolution of the frame.
+   *
+   * @param x_range Interval of x values
+   * @param function A function such that y=function(x)
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  template <typename F>
+    requires std::is_invocable_r_v<Real, F &, Real>
+  void Plot(const ranges::Interval<Real> &x_range, F &&function,
+            const float stroke_width = 2, const std::string &dash_array = {}) {
+    Plot(x_range, std::forward<F>(function), m_color_selector.NextColor(),
+         stroke_width, dash_array);
+  }
+
   /**
    * @brief Add a categorical plot with discrete text labels on the x axis and
    * Real numbers on the y axis.
@@ -183,6 +487,153 @@ public:
   void Scatter(const std::vector<Real> &x_data, const std::vector<Real> &y_data,
                const float radius = 2);
 
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length. The sequences are moved into the figure.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Marker color
+   * @param radius Marker radius
+   */
+  void Scatter(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+               const Color &color, const float radius = 2);
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length. The sequences are moved into the figure.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param radius Marker radius
+   */
+  void Scatter(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+               const float radius = 2);
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length. The sequences are borrowed, not copied: they
+   * must remain valid and unchanged while the plot is in the figure and the
+   * figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Marker color
+   * @param radius Marker radius
+   */
+  void Scatter(std::span<const Real> x_data, std::span<const Real> y_data,
+               const Color &color, const float radius = 2);
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length. The sequences are borrowed, not copied: they
+   * must remain valid and unchanged while the plot is in the figure and the
+   * figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param radius Marker radius
+   */
+  void Scatter(std::span<const Real> x_data, std::span<const Real> y_data,
+               const float radius = 2);
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The values are
+   * stored in their native type and converted when the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Marker color
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(const std::vector<T> &x_data, const std::vector<U> &y_data,
+               const Color &color, const float radius = 2) {
+    Scatter(std::vector<T>(x_data), std::vector<U>(y_data), color, radius);
+  }
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The values are
+   * stored in their native type and converted when the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(const std::vector<T> &x_data, const std::vector<U> &y_data,
+               const float radius = 2) {
+    Scatter(x_data, y_data, m_color_selector.NextColor(), radius);
+  }
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The sequences are
+   * moved into the figure in their native type.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Marker color
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(std::vector<T> &&x_data, std::vector<U> &&y_data,
+               const Color &color, const float radius = 2) {
+    ScatterNumeric(DataArray(std::move(x_data)), DataArray(std::move(y_data)),
+                   color, radius);
+  }
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The sequences are
+   * moved into the figure in their native type.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(std::vector<T> &&x_data, std::vector<U> &&y_data,
+               const float radius = 2) {
+    Scatter(std::move(x_data), std::move(y_data), m_color_selector.NextColor(),
+            radius);
+  }
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The sequences are
+   * borrowed, not copied: they must remain valid and unchanged while the plot
+   * is in the figure and the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param color Marker color
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(std::span<const T> x_data, std::span<const U> y_data,
+               const Color &color, const float radius = 2) {
+    ScatterNumeric(DataArray(x_data), DataArray(y_data), color, radius);
+  }
+
+  /**
+   * @brief Add a SCATTER plot consisting of an x-axis sequence and a y-axis
+   * sequence of the same length and of any numeric type. The sequences are
+   * borrowed, not copied: they must remain valid and unchanged while the plot
+   * is in the figure and the figure is built.
+   *
+   * @param x_data x-axis data
+   * @param y_data y-axis data
+   * @param radius Marker radius
+   */
+  template <DataElement T, DataElement U>
+  void Scatter(std::span<const T> x_data, std::span<const U> y_data,
+               const float radius = 2) {
+    Scatter(x_data, y_data, m_color_selector.NextColor(), radius);
+  }
+
   /**
    * @brief Add a categorical SCATTER plot with discrete text labels on the x
    * axis and Real numbers on the y axis.
@@ -211,6 +662,88 @@ public:
   void Scatter(const std::vector<std::string> &x_data,
                const std::vector<Real> &y_data, const float radius = 2);
 
+  /**
+   * @brief Add an empty line plot that keeps the last points appended to it.
+   * When the series is full, appending a point drops the oldest one.
+   *
+   * @param capacity Maximum number of points of the series
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   * @return Handle to append points to the series
+   */
+  SeriesHandle PlotStream(std::size_t capacity, const Color &color,
+                          const float stroke_width = 2,
+                          const std::string &dash_array = {});
+
+  /**
+   * @brief Add an empty line plot that keeps the last points appended to it.
+   * When the series is full, appending a point drops the oldest one.
+   *
+   * @param capacity Maximum number of points of the series
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   * @return Handle to append points to the series
+   */
+  SeriesHandle PlotStream(std::size_t capacity, const float stroke_width = 2,
+                          const std::string &dash_array = {});
+
+  /**
+   * @brief Append a point to a series added with PlotStream. The range of the
+   * series is updated in amortized constant time. Nothing is done if the
+   * series is no longer plotted.
+   *
+   * @param series Handle returned by PlotStream
+   * @param x x value
+   * @param y y value
+   */
+  void Append(SeriesHandle series, Real x, Real y);
+
+  /**
+   * @brief Append a sequence of points to a series added with PlotStream.
+   * Nothing is done if the series is no longer plotted.
+   *
+   * @param series Handle returned by PlotStream
+   * @param x_data x values
+   * @param y_data y values of the same length
+   */
+  void Append(SeriesHandle series, std::span<const Real> x_data,
+              std::span<const Real> y_data);
+
+  /**
+   * @brief Add a line plot of a function y=generator(x) that is evaluated when
+   * the figure is built, over the x range of the figure and at one sample per
+   * px of the frame. The samples are kept until the x range or the size of
+   * the figure changes. The x range is taken from the other series or
+   * SetXRange, and the series only extends the y range.
+   *
+   * The generator is called from several threads at the same time.
+   *
+   * @param generator A function such that y=generator(x)
+   * @param color Stroke color
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void PlotGenerator(const std::function<Real(Real)> &generator,
+                     const Color &color, const float stroke_width = 2,
+                     const std::string &dash_array = {});
+
+  /**
+   * @brief Add a line plot of a function y=generator(x) that is evaluated when
+   * the figure is built, over the x range of the figure.
+   *
+   * @param generator A function such that y=generator(x)
+   * @param stroke_width Line width
+   * @param dash_array Dash array (length of draw / no-draw segments in pt
+   * units)
+   */
+  void PlotGenerator(const std::function<Real(Real)> &generator,
+                     const float stroke_width = 2,
+                     const std::string &dash_array = {});
+
   /**
    * @brief Set hold on/off
    * Setting the hold on allows multiple data series to be plotted. If hold is
@@ -221,6 +754,117 @@ public:
   /** Enable / disable the grid */
   void SetGrid(bool enable);
 
+  /**
+   * @brief Set how scatter markers are drawn. In all modes, the markers of a
+   * series are grouped together.
+   */
+  void SetScatterMode(ScatterMode mode);
+
+  /**
+   * @brief Skip the scatter markers that would be drawn over an earlier marker
+   * of the same series. Markers are compared on a grid of a fraction of a px,
+   * so the skipped markers are less than a cell away from a drawn one.
+   * Density scatter plots are not affected.
+   *
+   * @param enable Whether overdrawn markers are skipped
+   * @param subpixels Number of cells per px in each direction
+   */
+  void SetOverdrawElimination(
+      bool enable, std::size_t subpixels = DEFAULT_OVERDRAW_SUBPIXELS);
+
+  /**
+   * @brief Simplify all line series, including the ones plotted later. Points
+   * are removed after they are translated to the frame, so the tolerance is
+   * given in px of the image.
+   *
+   * @param method Simplification algorithm
+   * @param tolerance Tolerance in px
+   */
+  void SetSimplification(
+      Simplification method,
+      float tolerance = DEFAULT_SIMPLIFICATION_TOLERANCE);
+
+  /**
+   * @brief Simplify one line series.
+   *
+   * @param series Index of the series, in the order they were plotted
+   * @param method Simplification algorithm
+   * @param tolerance Tolerance in px
+   */
+  void SetSimplification(
+      std::size_t series, Simplification method,
+      float tolerance = DEFAULT_SIMPLIFICATION_TOLERANCE);
+
+  /**
+   * @brief Decimate all line series, including the ones plotted later, when
+   * they have more points per px of the frame width than a threshold.
+   *
+   * @param method Decimation algorithm
+   * @param threshold Minimum number of points per px to decimate a series
+   */
+  void SetDecimation(Decimation method,
+                     float threshold = DEFAULT_DECIMATION_THRESHOLD);
+
+  /**
+   * @brief Decimate one line series when it has more points per px of the
+   * frame width than a threshold.
+   *
+   * @param series Index of the series, in the order they were plotted
+   * @param method Decimation algorithm
+   * @param threshold Minimum number of points per px to decimate a series
+   */
+  void SetDecimation(std::size_t series, Decimation method,
+                     float threshold = DEFAULT_DECIMATION_THRESHOLD);
+
+  /**
+   * @brief Downsample all line series, including the ones plotted later, with
+   * the Largest-Triangle-Three-Buckets algorithm. Only the points in the
+   * visible x range are downsampled.
+   *
+   * @param max_points Maximum number of points per series, or 0 to draw all
+   * points
+   */
+  void SetDownsampling(std::size_t max_points);
+
+  /**
+   * @brief Downsample one line series with the Largest-Triangle-Three-Buckets
+   * algorithm.
+   *
+   * @param series Index of the series, in the order they were plotted
+   * @param max_points Maximum number of points of the series, or 0 to draw
+   * all points
+   */
+  void SetDownsampling(std::size_t series, std::size_t max_points);
+
+  /**
+   * @brief Set the type that the values of all numeric series, including the
+   * ones plotted later, are stored as. Only values owned by the figure are
+   * converted: borrowed values, streams and generators keep their type.
+   *
+   * @param precision Storage type of the values
+   */
+  void SetStoragePrecision(StoragePrecision precision);
+
+  /**
+   * @brief Set the type that the values of one numeric series are stored as.
+   *
+   * @param series Index of the series, in the order they were plotted
+   * @param precision Storage type of the values
+   */
+  void SetStoragePrecision(std::size_t series, StoragePrecision precision);
+
+  /** Returns the statistics of the last time the data series were drawn */
+  const DataStats &GetDataStats() const;
+
+  /**
+   * @brief Set the number of threads that generate the paths of the line
+   * series. The output does not depend on the number of threads.
+   *
+   * @param num_threads Number of threads, or 0 to use the pool shared by the
+   * library, with one thread per hardware core
+   */
+  void SetNumThreads(std::size_t num_threads);
+
   /**
    * @brief Set a range for the x axis
    *
@@ -295,26 +939,67 @@ public:
   /** Clear plot data */
   void ClearData();
 
-  /** Build the figure */
+  /**
+   * @brief Build the figure. Only the layers invalidated since the last build
+   * are drawn again.
+   */
   void Build() override;
 
 protected:
+  struct SimplificationSettings {
+    Simplification method;
+    float tolerance;
+  };
+
+  struct DecimationSettings {
+    Decimation method;
+    float threshold;
+  };
+
   struct Style {
     Color color;
     float stroke;
     std::string dash_array;
     bool scatter;
+    SimplificationSettings simplification;
+    DecimationSettings decimation;
+    std::size_t max_points;
   };
 
-  struct DataSeries {
+  /** Function of x and its last samples, with the x range and frame size
+   * they were taken for. Functions with a domain are sampled adaptively in
+   * it, and the others uniformly over the x range of the figure. */
+  struct Generator {
+    std::function<Real(Real)> function;
+    std::optional<ranges::Interval<Real>> domain;
     std::vector<Real> x;
     std::vector<Real> y;
+    ranges::Interval<Real> x_range;
+    float frame_w;
+    float frame_h;
+  };
+
+  /** Data series with the range of their finite values and whether their x
+   * values are sorted, which are computed once when the series is added.
+   * Streamed series borrow the window of their buffer and take both from it.
+   * Generated series borrow the samples of their generator and are updated
+   * when the frame is calculated. The visible points of sorted series are
+   * found with binary searches. */
+  struct DataSeries {
+    DataArray x;
+    DataArray y;
     Style style;
+    ranges::Interval<Real> x_range;
+    ranges::Interval<Real> y_range;
+    bool x_sorted;
+    std::shared_ptr<StreamBuffer> stream;
+    std::shared_ptr<Generator> generator;
   };
 
   struct CategoricalDataSeries {
     std::vector<Real> y;
     Style style;
+    ranges::Interval<Real> y_range;
   };
 
   bool m_hold = true;
@@ -356,9 +1041,58 @@ protected:
 
   bool m_grid_enable = false;
 
-  /** Translate the (x, y) coordinates from the plot function to (x, y) in the
-   * svg image */
-  std::pair<float, float> TranslateToFrame(Real x, Real y) const;
+  ScatterMode m_scatter_mode = ScatterMode::CIRCLES;
+
+  /** Cells per px of the overdraw grid, or 0 to draw all markers */
+  std::size_t m_overdraw_subpixels = 0;
+
+  SimplificationSettings m_simplification = {
+      Simplification::NONE, DEFAULT_SIMPLIFICATION_TOLERANCE};
+
+  DecimationSettings m_decimation = {Decimation::M4,
+                                     DEFAULT_DECIMATION_THRESHOLD};
+
+  std::size_t m_max_points = 0;
+
+  StoragePrecision m_storage_precision = StoragePrecision::NATIVE;
+
+  DataStats m_data_stats;
+
+  /** Pool of the figure, or null to use the default pool */
+  std::shared_ptr<ThreadPool> m_thread_pool;
+
+  /** Group clipped to the frame that contains all data series */
+  svg::Node m_data_layer;
+
+  /** Mark the layers that depend on the data series to be drawn again */
+  void InvalidateData();
+
+  /** Add a numeric line series if both sequences have the same length */
+  void PlotNumeric(DataArray &&x_data, DataArray &&y_data, const Color &color,
+                   const float stroke_width, const std::string &dash_array);
+
+  /** Add a numeric scatter series if both sequences have the same length */
+  void ScatterNumeric(DataArray &&x_data, DataArray &&y_data,
+                      const Color &color, const float radius);
+
+  /** Add a numeric series, replacing the previous ones if hold is disabled */
+  void AddNumericSeries(DataArray &&x_data, DataArray &&y_data,
+                        const Style &style);
+
+  /** Convert the values of a series owned by the figure to a storage type
+   * and update their ranges */
+  void ConvertStorage(DataSeries &plot, StoragePrecision precision);
+
+  /** Affine maps of x and y values to svg image coordinates */
+  transform::Affine FrameTransformX() const;
+  transform::Affine FrameTransformY() const;
+
+  /** Frame of the svg image expanded by a margin in px */
+  clipping::Rect FrameRect(float margin) const;
+
+  /** Size of the frame in px for the current size of the figure */
+  float FrameWidth() const;
+  float FrameHeight() const;
 
   // Constraints
   static constexpr float FRAME_TOP_MARGIN_REL = 0.10f;
@@ -366,6 +1100,7 @@ protected:
   static constexpr float FRAME_LEFT_MARGIN_REL = 0.15f;
   static constexpr float FRAME_RIGHT_MARGIN_REL = 0.05f;
   static const std::string FRAME_RECT_CLIP_PATH_ID;
+  static const std::string FRAME_RECT_CLIP_PATH_URL;
 
   static constexpr Color BACKGROUND_COLOR = {255, 255, 255};
 
@@ -385,19 +1120,84 @@ protected:
   /** Calculate all frame parameters needed to draw the plots. */
   void CalculateFrame();
   void CalculateNumericFrame();
+
+  /** Add a line series generated by a function, with an optional domain */
+  void AddGenerator(const std::function<Real(Real)> &function,
+                    const std::optional<ranges::Interval<Real>> &domain,
+                    const Color &color, const float stroke_width,
+                    const std::string &dash_array);
+
+  /** Sample a generated series over the visible x range at the resolution of
+   * the frame, unless it was already sampled for them */
+  void SampleGenerator(DataSeries &plot);
   void CalculateCategoricalFrame();
 
   void DrawBackground();
   void DrawFrame();
 
   void DrawData();
+  /** Polylines of a line series translated to the frame */
+  struct FramePath {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<std::size_t> polyline_sizes;
+    DataStats stats;
+  };
+
+  /** Path data of a line series and the statistics of its reduction */
+  struct SeriesPath {
+    std::string data;
+    DataStats stats;
+  };
+
+  /** Returns the pool that generates the paths of the line series */
+  ThreadPool &GetThreadPool() const;
+
   void DrawNumericData();
-  void DrawNumericPath(const DataSeries &plot);
+
+  /**
+   * @brief Translate a line series to the frame and reduce its points. This
+   * does not modify the figure, so series can be translated in parallel.
+   */
+  FramePath TranslateNumericPath(const DataSeries &plot) const;
+
+  /** Translate a line series and format its path data. Thread-safe. */
+  SeriesPath FormatNumericPath(const DataSeries &plot) const;
+  void DrawNumericPath(const DataSeries &plot, const SeriesPath &series_path);
+
+  /**
+   * @brief Simplify a polyline in place with the method of the series style.
+   *
+   * @return Number of points kept at the beginning of the arrays
+   */
+  static std::size_t SimplifyPolyline(float *x, float *y, std::size_t size,
+                                      const Style &style);
   void DrawNumericScatter(const DataSeries &plot);
   void DrawCategoricalData();
-  void DrawCategoricalPath(const CategoricalDataSeries &plot);
+  /** Format the path data of a categorical line series. Thread-safe. */
+  std::string FormatCategoricalPath(const CategoricalDataSeries &plot) const;
+  void DrawCategoricalPath(const CategoricalDataSeries &plot,
+                           const std::string &path_data);
   void DrawCategoricalScatter(const CategoricalDataSeries &plot);
 
+  /** Returns the id of the marker definition of a scatter style. Styles with
+   * the same marker share the id. */
+  static std::string ScatterMarkerId(const Style &style);
+
+  /** Define the markers of all scatter series in <defs> */
+  void DefineScatterMarkers();
+
+  /**
+   * @brief Draw the markers of a scatter series in a group. Overdrawn markers
+   * are removed from the coordinates if overdraw elimination is enabled.
+   *
+   * @param x x coordinates in the svg image
+   * @param y y coordinates in the svg image
+   * @param style Series style
+   */
+  void DrawScatterMarkers(std::vector<float> &x, std::vector<float> &y,
+                          const Style &style);
+
   void DrawTitle();
   void DrawLabels();
 
@@ -0,0 +1,117 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_STREAM_BUFFER_HPP_
+#define _PLOTCPP_INCLUDE_STREAM_BUFFER_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "utility.hpp"
+
+namespace plotcpp {
+
+/**
+ * @brief Fixed-capacity buffer of the last (x, y) points appended to a
+ * series.
+ *
+ * Every value is written twice, at its position in the ring and one capacity
+ * later, so that the points in the window are always contiguous and can be
+ * read as a span without copying them.
+ *
+ * The range of the finite values in the window is kept up to date with
+ * monotonic deques, so appending a point costs amortized O(1) and the range
+ * never needs to scan the window. Whether the x values are sorted is tracked
+ * in the same way.
+ */
+class StreamBuffer {
+public:
+  /**
+   * @brief Construct an empty buffer.
+   *
+   * @param capacity Maximum number of points in the window
+   */
+  explicit StreamBuffer(std::size_t capacity);
+
+  /** Append a point, dropping the oldest one if the buffer is full */
+  void Append(Real x, Real y);
+
+  /** Append a sequence of points. Sequences of different size are ignored. */
+  void Append(std::span<const Real> x_data, std::span<const Real> y_data);
+
+  /** Returns the maximum number of points in the window */
+  std::size_t Capacity() const;
+
+  /** Returns the number of points in the window */
+  std::size_t Size() const;
+
+  /** Returns the x values of the window, from the oldest to the newest */
+  std::span<const Real> X() const;
+
+  /** Returns the y values of the window, from the oldest to the newest */
+  std::span<const Real> Y() const;
+
+  /** Returns the range of the finite x values of the window */
+  ranges::Interval<Real> XRange() const;
+
+  /** Returns the range of the finite y values of the window */
+  ranges::Interval<Real> YRange() const;
+
+  /** Returns true if the x values of the window are in non-decreasing order */
+  bool IsXSorted() const;
+
+private:
+  /** Minimum and maximum of the finite values of a sliding window */
+  class SlidingRange {
+  public:
+    /** Add the value appended with a sequence number */
+    void Push(std::size_t sequence, Real value);
+
+    /** Remove the values appended before a sequence number */
+    void Evict(std::size_t first_sequence);
+
+    ranges::Interval<Real> Range() const;
+
+  private:
+    // Candidates in order of sequence, with increasing minimum and decreasing
+    // maximum values
+    std::deque<std::pair<std::size_t, Real>> m_min;
+    std::deque<std::pair<std::size_t, Real>> m_max;
+  };
+
+  std::size_t m_capacity;
+  std::vector<Real> m_x;
+  std::vector<Real> m_y;
+  std::size_t m_start = 0;
+  std::size_t m_size = 0;
+  std::size_t m_num_appended = 0;
+
+  // Number of consecutive pairs of x values of the window that are not in
+  // order
+  std::size_t m_num_x_descents = 0;
+
+  SlidingRange m_x_range;
+  SlidingRange m_y_range;
+};
+
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_STREAM_BUFFER_HPP_
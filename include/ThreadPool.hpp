@@ -0,0 +1,90 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_THREAD_POOL_HPP_
+#define _PLOTCPP_INCLUDE_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace plotcpp {
+
+/**
+ * @brief A fixed set of threads that run the iterations of parallel loops.
+ *
+ * The threads are started once and reused by every loop, so running a loop
+ * does not create threads. Loops can be run by several threads at the same
+ * time.
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief Start a pool.
+   *
+   * @param num_threads Number of threads that run a loop, including the
+   * calling thread, or 0 to use one thread per hardware core
+   */
+  explicit ThreadPool(std::size_t num_threads = 0);
+
+  /** Wait for the running loops and stop the threads */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /** Returns the pool shared by the library, with one thread per core */
+  static ThreadPool &Default();
+
+  /** Returns the number of threads that run a loop */
+  std::size_t NumThreads() const;
+
+  /**
+   * @brief Call a function for every index from 0 to count - 1 and wait until
+   * all calls return. The calls are distributed between the calling thread
+   * and the threads of the pool in no particular order.
+   *
+   * If a call throws, the iterations that did not start are skipped and the
+   * first exception is rethrown once the running calls return. Loops can be
+   * nested, since the calling thread runs the iterations that no thread of
+   * the pool takes.
+   *
+   * @param count Number of iterations
+   * @param function Function called with the index of each iteration
+   */
+  void ParallelFor(std::size_t count,
+                   const std::function<void(std::size_t)> &function);
+
+private:
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop = false;
+
+  /** Run tasks until the pool is stopped */
+  void Work();
+};
+
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_THREAD_POOL_HPP_
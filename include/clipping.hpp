@@ -0,0 +1,67 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_CLIPPING_HPP_
+#define _PLOTCPP_INCLUDE_CLIPPING_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace plotcpp {
+namespace clipping {
+
+/** Axis-aligned rectangle */
+struct Rect {
+  float x0;
+  float y0;
+  float x1;
+  float y1;
+
+  /** Returns true if a point is inside the rectangle or on its border */
+  bool Contains(float x, float y) const {
+    return (x >= x0) && (x <= x1) && (y >= y0) && (y <= y1);
+  }
+};
+
+/**
+ * @brief Clip a polyline to a rectangle with the Liang-Barsky algorithm.
+ * Segments that cross the border are cut at the border, and the polyline is
+ * split where it leaves the rectangle. Points with NaN coordinates are
+ * treated as outside.
+ *
+ * The visible pieces are appended to the output arrays. Points inside the
+ * rectangle are copied exactly.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param rect Clipping rectangle
+ * @param out_x x coordinates of the visible pieces
+ * @param out_y y coordinates of the visible pieces
+ * @param piece_sizes Number of points of each visible piece
+ * @return Number of points of the polyline outside the rectangle
+ */
+std::size_t ClipPolyline(const float *x, const float *y, std::size_t size,
+                         const Rect &rect, std::vector<float> &out_x,
+                         std::vector<float> &out_y,
+                         std::vector<std::size_t> &piece_sizes);
+
+} // namespace clipping
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_CLIPPING_HPP_
@@ -0,0 +1,73 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_DENSITY_HPP_
+#define _PLOTCPP_INCLUDE_DENSITY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ThreadPool.hpp"
+#include "utility.hpp"
+
+namespace plotcpp {
+namespace density {
+
+/** Number of points in each cell of a grid, row by row from the top */
+struct Grid {
+  std::size_t width;
+  std::size_t height;
+  std::vector<std::uint32_t> counts;
+};
+
+/**
+ * @brief Count the points in each cell of a grid of 1x1 cells. Chunks of the
+ * points are counted in parallel into separate grids, which are added at the
+ * end.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param x0 x coordinate of the left side of the grid
+ * @param y0 y coordinate of the top side of the grid
+ * @param width Number of columns
+ * @param height Number of rows
+ * @param pool Pool that counts the chunks
+ * @return Grid of counts. Points outside the grid are not counted.
+ */
+Grid Accumulate(const float *x, const float *y, std::size_t size, float x0,
+                float y0, std::size_t width, std::size_t height,
+                ThreadPool &pool);
+
+/**
+ * @brief Map the counts of a grid to RGBA pixels. Counts are scaled
+ * logarithmically between 0 and the maximum count and interpolated in a
+ * colormap. Empty cells are transparent.
+ *
+ * @param grid Grid of counts
+ * @param colormap Colors from low to high counts
+ * @return Pixels with 4 bytes each
+ */
+std::vector<std::uint8_t> Colorize(const Grid &grid,
+                                   const std::vector<Color> &colormap);
+
+} // namespace density
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_DENSITY_HPP_
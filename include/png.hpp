@@ -0,0 +1,46 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_PNG_HPP_
+#define _PLOTCPP_INCLUDE_PNG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace plotcpp {
+namespace png {
+
+/**
+ * @brief Encode an 8-bit RGBA image as PNG.
+ *
+ * @param rgba Pixels, row by row from the top, with 4 bytes per pixel
+ * @param width Width in px
+ * @param height Height in px
+ * @return PNG file contents, or an empty string if compression fails
+ */
+std::string Encode(const std::uint8_t *rgba, std::size_t width,
+                   std::size_t height);
+
+/** Returns a data URI with the base64 encoding of a PNG file */
+std::string DataUri(const std::string &png);
+
+} // namespace png
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_PNG_HPP_
@@ -0,0 +1,79 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_REDUCTION_HPP_
+#define _PLOTCPP_INCLUDE_REDUCTION_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "DataArray.hpp"
+#include "utility.hpp"
+
+namespace plotcpp {
+namespace reduction {
+
+/** Range of a sequence without finite values, which is the identity of
+ * Combine */
+constexpr ranges::Interval<Real> EMPTY_RANGE = {
+    std::numeric_limits<Real>::max(), std::numeric_limits<Real>::lowest()};
+
+/**
+ * @brief Returns the range of the finite values of a sequence. Infinite and
+ * NaN values are skipped.
+ *
+ * Sequences of Real and float values are reduced with AVX2 when the CPU
+ * supports it.
+ *
+ * @param values Sequence of values
+ * @return Minimum and maximum finite values, or {max(), lowest()} if there
+ * are none, so that combining it with other ranges has no effect
+ */
+ranges::Interval<Real> FiniteRange(std::span<const Real> values);
+
+/** Returns the range of the finite values of an array of any type */
+ranges::Interval<Real> FiniteRange(const DataArray &values);
+
+/**
+ * @brief Returns true if the values of an array are in non-decreasing order.
+ * Arrays with NaN values are not sorted.
+ */
+bool IsSorted(const DataArray &values);
+
+/**
+ * @brief Find the values of a sorted array that are in an interval with a
+ * binary search.
+ *
+ * @param values Array sorted in non-decreasing order
+ * @param interval Closed interval
+ * @return Index of the first value in the interval and index after the last
+ * one. Both are equal if no value is in the interval.
+ */
+std::pair<std::size_t, std::size_t>
+SortedWindow(const DataArray &values, const ranges::Interval<Real> &interval);
+
+/** Returns the union of two ranges */
+ranges::Interval<Real> Combine(const ranges::Interval<Real> &a,
+                               const ranges::Interval<Real> &b);
+
+} // namespace reduction
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_REDUCTION_HPP_
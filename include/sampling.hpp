@@ -0,0 +1,250 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_SAMPLING_HPP_
+#define _PLOTCPP_INCLUDE_SAMPLING_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace plotcpp {
+namespace sampling {
+
+/**
+ * @brief Simplify a polyline with the Ramer-Douglas-Peucker algorithm. Points
+ * closer than a tolerance to the simplified line are removed. The first and
+ * last points are always kept.
+ *
+ * The kept points are moved to the front of the arrays in their original
+ * order.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param tolerance Maximum distance from a removed point to the simplified
+ * polyline, in the units of the coordinates
+ * @return Number of points kept
+ */
+std::size_t SimplifyDouglasPeucker(float *x, float *y, std::size_t size,
+                                   float tolerance);
+
+/**
+ * @brief Simplify a polyline with the Visvalingam-Whyatt algorithm. The point
+ * that forms the triangle of smallest area with its neighbours is removed
+ * repeatedly until all triangles are larger than the square of the
+ * tolerance. The first and last points are always kept.
+ *
+ * The kept points are moved to the front of the arrays in their original
+ * order.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param tolerance Square root of the minimum area of a triangle, in the
+ * units of the coordinates
+ * @return Number of points kept
+ */
+std::size_t SimplifyVisvalingam(float *x, float *y, std::size_t size,
+                                float tolerance);
+
+/**
+ * @brief Decimate a polyline with the M4 algorithm. Consecutive points that
+ * fall in the same pixel column are reduced to the first, last, minimum and
+ * maximum points of the column, so that the rasterized line is the same.
+ *
+ * Columns are one unit wide and start at x_min. Points outside
+ * [x_min, x_max) are gathered into a single column at each side.
+ *
+ * The kept points are moved to the front of the arrays in their original
+ * order.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param x_min Left side of the first column
+ * @param x_max Right side of the last column
+ * @return Number of points kept
+ */
+std::size_t DecimateM4(float *x, float *y, std::size_t size, float x_min,
+                       float x_max);
+
+/**
+ * @brief Downsample a polyline with the Largest-Triangle-Three-Buckets
+ * algorithm. The points between the first and the last are split into
+ * buckets, and the point of each bucket that forms the largest triangle with
+ * the previous kept point and the average of the next bucket is kept.
+ *
+ * The kept points are moved to the front of the arrays in their original
+ * order.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of points
+ * @param max_points Maximum number of points kept. The first and last points
+ * are always kept.
+ * @return Number of points kept
+ */
+std::size_t DownsampleLTTB(float *x, float *y, std::size_t size,
+                           std::size_t max_points);
+
+/**
+ * @brief Remove the markers that fall on the same cell of a sub-pixel grid as
+ * an earlier marker. Markers of the same size that are less than a cell apart
+ * are drawn the same, so only the first one is kept. Occupied cells are
+ * tracked in a bitmap with one bit per cell.
+ *
+ * Markers outside the rectangle of the grid are kept. The kept markers are
+ * moved to the front of the arrays in their original order.
+ *
+ * @param x x coordinates
+ * @param y y coordinates
+ * @param size Number of markers
+ * @param x_min Left side of the grid
+ * @param y_min Top side of the grid
+ * @param x_max Right side of the grid
+ * @param y_max Bottom side of the grid
+ * @param subpixels Number of cells per unit of the coordinates in each
+ * direction
+ * @return Number of markers kept
+ */
+std::size_t RemoveOverdrawn(float *x, float *y, std::size_t size, float x_min,
+                            float y_min, float x_max, float y_max,
+                            std::size_t subpixels);
+
+/** Distance in px between the samples of the initial grid of SampleAdaptive */
+constexpr float ADAPTIVE_INITIAL_STEP = 8.0f;
+
+/** Distance in px below which SampleAdaptive does not split intervals */
+constexpr float ADAPTIVE_MIN_STEP = 0.5f;
+
+/**
+ * Distance in px between the midpoint of an interval and its chord below
+ * which SampleAdaptive does not split the interval
+ */
+constexpr float ADAPTIVE_TOLERANCE = 0.25f;
+
+/**
+ * @brief Sample a function of x at the resolution it is drawn at. The
+ * function is first evaluated on a uniform grid of one sample every
+ * ADAPTIVE_INITIAL_STEP px. Then each interval is split in halves while its
+ * midpoint is further than ADAPTIVE_TOLERANCE px from the chord or some of
+ * its values are not finite, down to intervals of ADAPTIVE_MIN_STEP px. Flat
+ * stretches keep the initial grid and curves, jumps and the edges of the
+ * domain of the function are refined.
+ *
+ * The y resolution is estimated from the range of the initial grid, so
+ * refinement is finer than needed if the axis spans a wider range.
+ *
+ * @param function A function such that y=function(x)
+ * @param x_min First x value
+ * @param x_max Last x value
+ * @param width Width of [x_min, x_max] in px
+ * @param height Height of the range of the function in px
+ * @return The x and y values, in increasing order of x
+ */
+template <typename T, typename F>
+std::pair<std::vector<T>, std::vector<T>>
+SampleAdaptive(F &function, T x_min, T x_max, float width, float height) {
+  if (!(x_min < x_max) || !(width > 0) || !(height > 0)) {
+    return {};
+  }
+
+  const std::size_t num_intervals = std::max<std::size_t>(
+      2, static_cast<std::size_t>(width / ADAPTIVE_INITIAL_STEP));
+  std::vector<T> grid_x(num_intervals + 1);
+  std::vector<T> grid_y(num_intervals + 1);
+  for (std::size_t i = 0; i <= num_intervals; ++i) {
+    grid_x[i] = (i == num_intervals)
+                    ? x_max
+                    : x_min + (x_max - x_min) * static_cast<T>(i) /
+                                  static_cast<T>(num_intervals);
+    grid_y[i] = function(grid_x[i]);
+  }
+
+  T y_min = 0;
+  T y_max = 0;
+  bool any_finite = false;
+  for (const T value : grid_y) {
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    y_min = any_finite ? std::min(y_min, value) : value;
+    y_max = any_finite ? std::max(y_max, value) : value;
+    any_finite = true;
+  }
+  const double y_span = (y_max > y_min) ? static_cast<double>(y_max - y_min)
+                                        : std::max(std::abs(y_max), T(1));
+
+  // Intervals are compared in px so that the same tolerance holds in x and y
+  const double x_scale = static_cast<double>(width) / (x_max - x_min);
+  const double y_scale = static_cast<double>(height) / y_span;
+
+  struct Interval {
+    T x0, y0, x1, y1;
+  };
+
+  std::vector<T> x{grid_x[0]};
+  std::vector<T> y{grid_y[0]};
+  std::vector<Interval> stack;
+  for (std::size_t i = 0; i < num_intervals; ++i) {
+    stack.push_back({grid_x[i], grid_y[i], grid_x[i + 1], grid_y[i + 1]});
+
+    // Intervals are split depth first so that samples are emitted in order
+    while (!stack.empty()) {
+      const Interval interval = stack.back();
+      stack.pop_back();
+
+      if ((interval.x1 - interval.x0) * x_scale < 2 * ADAPTIVE_MIN_STEP) {
+        x.push_back(interval.x1);
+        y.push_back(interval.y1);
+        continue;
+      }
+
+      const T x_mid = interval.x0 + (interval.x1 - interval.x0) / 2;
+      const T y_mid = function(x_mid);
+
+      const bool finite = std::isfinite(interval.y0) &&
+                          std::isfinite(y_mid) && std::isfinite(interval.y1);
+      const bool undefined = !std::isfinite(interval.y0) &&
+                             !std::isfinite(y_mid) &&
+                             !std::isfinite(interval.y1);
+      const bool smooth =
+          finite &&
+          std::abs(y_mid - (interval.y0 + interval.y1) / 2) * y_scale <=
+              ADAPTIVE_TOLERANCE;
+
+      if (smooth || undefined) {
+        x.insert(x.end(), {x_mid, interval.x1});
+        y.insert(y.end(), {y_mid, interval.y1});
+      } else {
+        stack.push_back({x_mid, y_mid, interval.x1, interval.y1});
+        stack.push_back({interval.x0, interval.y0, x_mid, y_mid});
+      }
+    }
+  }
+
+  return {std::move(x), std::move(y)};
+}
+
+} // namespace sampling
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_SAMPLING_HPP_
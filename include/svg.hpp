@@ -22,9 +22,13 @@
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "utility.hpp"
@@ -33,10 +37,60 @@ namespace plotcpp {
 
 namespace svg {
 
-xmlNode *AppendNode(xmlNode *parent, const std::string &name);
+class Document;
 
-void SetAttribute(xmlNode *node, const std::string &name,
-                  const std::string &value, const std::string &unit = "");
+/**
+ * @brief Handle to an element of a Document.
+ *
+ * Depending on the backend of the document that created it, a node refers to
+ * a libxml2 node or to an element of a streaming document. A default
+ * constructed node is null.
+ */
+struct Node {
+  Node() = default;
+  Node(xmlNodePtr xml_node) : xml(xml_node) {}
+  Node(Document *stream_document, std::size_t stream_id)
+      : document(stream_document), id(stream_id) {}
+
+  bool IsNull() const { return (xml == nullptr) && (document == nullptr); }
+
+  xmlNodePtr xml = nullptr;
+  Document *document = nullptr;
+  std::size_t id = 0;
+};
+
+Node AppendNode(Node parent, const std::string &name);
+
+void SetAttribute(Node node, const std::string &name, const std::string &value,
+                  const std::string &unit = "");
+
+/** Set the text content of a node */
+void SetContent(Node node, const std::string &content);
+
+/** Precision that formats numbers with the shortest round-trip
+ * representation */
+static constexpr int SHORTEST_PRECISION = -1;
+
+/** Maximum number of decimals used to format numbers */
+static constexpr int MAX_PRECISION = 9;
+
+/**
+ * @brief Append a number to a buffer. Trailing zeros are trimmed.
+ *
+ * @param out Output buffer
+ * @param value Value
+ * @param precision Maximum number of decimals, or SHORTEST_PRECISION
+ */
+void AppendNumber(std::string &out, float value,
+                  int precision = SHORTEST_PRECISION);
+
+/**
+ * @brief Format a number. Trailing zeros are trimmed.
+ *
+ * @param value Value
+ * @param precision Maximum number of decimals, or SHORTEST_PRECISION
+ */
+std::string FormatNumber(float value, int precision = SHORTEST_PRECISION);
 
 struct Line {
   float x1, y1, x2, y2;
@@ -64,8 +118,21 @@ struct Circle {
   Color fill_color{0, 0, 0};
 };
 
+/** An instance of an element defined elsewhere in the document */
+struct Use {
+  std::string href;
+  float x, y;
+};
+
+/** A raster image, stretched over a rectangle without smoothing */
+struct Image {
+  std::string href;
+  float x, y;
+  float width, height;
+};
+
 struct PathCommand {
-  enum class Id {
+  enum class Id : uint8_t {
     MOVE,
     MOVE_R,
     LINE,
@@ -78,14 +145,35 @@ struct PathCommand {
     CLOSE,
   };
 
-  Id id;
-  std::vector<float> args;
-
-  std::string ToString() const;
+  /** Returns the number of arguments taken by a command */
+  static constexpr std::size_t NumArgs(Id id) {
+    switch (id) {
+    case Id::MOVE:
+    case Id::MOVE_R:
+    case Id::LINE:
+    case Id::LINE_R:
+      return 2;
+    case Id::VERTICAL:
+    case Id::VERTICAL_R:
+    case Id::HORIZONTAL:
+    case Id::HORIZONTAL_R:
+      return 1;
+    case Id::QUADRATIC_R:
+      return 4;
+    case Id::CLOSE:
+      return 0;
+    }
+    return 0;
+  }
 };
 
+/**
+ * @brief A path. Commands and their arguments are stored in two flat buffers
+ * so that adding a command does not allocate once the buffers are reserved.
+ */
 struct Path {
-  std::vector<PathCommand> commands;
+  std::vector<PathCommand::Id> commands;
+  std::vector<float> args;
   float stroke_width = 1;
   Color stroke_color{0, 0, 0};
   float stroke_opacity = 1.0f;
@@ -93,8 +181,38 @@ struct Path {
   float fill_opacity = 1.0f;
   bool fill_transparent = true;
 
-  void Add(const PathCommand &command);
+  /** Add a command. The number of arguments must match the command. */
+  void Add(PathCommand::Id id, std::initializer_list<float> command_args);
+
+  void MoveTo(float x, float y) {
+    commands.push_back(PathCommand::Id::MOVE);
+    args.push_back(x);
+    args.push_back(y);
+  }
+
+  void LineTo(float x, float y) {
+    commands.push_back(PathCommand::Id::LINE);
+    args.push_back(x);
+    args.push_back(y);
+  }
+
+  /**
+   * @brief Append a polyline from coordinate arrays. The first point starts a
+   * new subpath.
+   *
+   * @param x x coordinates
+   * @param y y coordinates
+   * @param size Number of points
+   */
+  void AddPolyline(const float *x, const float *y, std::size_t size);
+
+  /** Reserve space for a number of commands and arguments */
+  void Reserve(std::size_t num_commands, std::size_t num_args);
+
   void Clear();
+
+  /** Append the path data (the d attribute) to a buffer */
+  void AppendData(std::string &out, int precision = SHORTEST_PRECISION) const;
 };
 
 struct Text {
@@ -109,18 +227,76 @@ std::string ColorToString(const Color &color);
 
 /**
  * /brief An SVG document
+ *
+ * A document is backed either by a libxml2 tree (DOM) or by a byte buffer
+ * that elements are serialized into as soon as they are drawn (STREAM). The
+ * streaming backend only keeps the chain of open elements in memory, so
+ * attributes and children can only be added to the most recently drawn
+ * element and its ancestors.
+ *
+ * The presentation attributes of lines, rectangles, circles and paths are not
+ * repeated on every element. Each distinct combination is written once as a
+ * rule of a <style> sheet in <defs> and elements refer to it by class name.
  */
 class Document {
 public:
-  Document();
+  enum class Backend {
+    DOM,
+    STREAM,
+  };
+
+  explicit Document(Backend backend = Backend::DOM);
 
   ~Document();
 
+  /** Receives consecutive chunks of the xml text of a document */
+  using Writer = std::function<void(const char *data, std::size_t size)>;
+
   /** Return the xml text */
   std::string GetText() const;
 
+  /**
+   * @brief Serialize the document in chunks, without building the whole xml
+   * text in memory.
+   *
+   * @param writer Function called with every chunk of text in order
+   */
+  void Write(const Writer &writer) const;
+
+  /** Returns the libxml2 document. Only populated by the DOM backend. */
   xmlDocPtr GetDoc();
 
+  /** Returns the document backend */
+  Backend GetBackend() const;
+
+  /** Set the document backend. This clears all elements in the document. */
+  void SetBackend(Backend backend);
+
+  /**
+   * @brief Set the maximum number of decimals of the numbers in the document.
+   * Elements that are already drawn are not affected.
+   *
+   * @param precision Number of decimals from 0 to MAX_PRECISION, or
+   * SHORTEST_PRECISION to write the shortest representation that round-trips.
+   */
+  void SetPrecision(int precision);
+
+  /** Returns the maximum number of decimals of the numbers in the document */
+  int GetPrecision() const;
+
+  /**
+   * @brief Write the document without indentation or line breaks between
+   * elements. The streaming backend serializes elements as they are drawn, so
+   * elements that are already drawn are not affected.
+   */
+  void SetCompact(bool compact);
+
+  /** Returns true if the document is written without indentation */
+  bool IsCompact() const;
+
+  /** Format a number with the precision of this document */
+  std::string FormatNumber(float value) const;
+
   /** Clear all elements in this document */
   void Reset();
 
@@ -134,43 +310,163 @@ public:
    */
   void SetSize(unsigned int width, unsigned int height);
 
+  /** Append a libxml2 node to the root. The document takes its ownership. */
   void Append(xmlNodePtr node);
 
+  /**
+   * @brief Append another document as a nested <svg> element.
+   *
+   * @param document Document to copy
+   * @param x Horizontal position of the nested document in px
+   * @param y Vertical position of the nested document in px
+   */
+  void AppendDocument(const Document &document, unsigned int x, unsigned int y);
+
   /** Draw background color */
-  xmlNodePtr DrawBackground(Color color);
+  Node DrawBackground(Color color);
 
   /** Draw a line */
-  xmlNodePtr DrawLine(const Line &line, xmlNodePtr parent_node = nullptr,
-                      const std::string &id = "");
+  Node DrawLine(const Line &line, Node parent_node = {},
+                const std::string &id = "");
 
   /** Draw a rectangle */
-  xmlNodePtr DrawRect(const Rect &rect, xmlNodePtr parent_node = nullptr,
-                      const std::string &id = "");
+  Node DrawRect(const Rect &rect, Node parent_node = {},
+                const std::string &id = "");
 
   /** Draw a circle */
-  xmlNodePtr DrawCircle(const Circle &circle, xmlNodePtr parent_node = nullptr,
-                        const std::string &id = "");
+  Node DrawCircle(const Circle &circle, Node parent_node = {},
+                  const std::string &id = "");
 
   /** Draw a path */
-  xmlNodePtr DrawPath(const Path &path, xmlNodePtr parent_node = nullptr,
-                      const std::string &id = "");
+  Node DrawPath(const Path &path, Node parent_node = {},
+                const std::string &id = "");
+
+  /**
+   * @brief Draw a path whose data was formatted beforehand, for example in
+   * another thread. The commands of the path are ignored.
+   *
+   * @param path Style of the path
+   * @param path_data Data written by Path::AppendData with the precision of
+   * this document
+   * @param parent_node Parent node
+   * @param id Id of the path
+   */
+  Node DrawPath(const Path &path, const std::string &path_data,
+                Node parent_node = {}, const std::string &id = "");
+
+  /** Draw an instance of another element */
+  Node DrawUse(const Use &use, Node parent_node = {},
+               const std::string &id = "");
+
+  /** Draw a raster image */
+  Node DrawImage(const Image &image, Node parent_node = {},
+                 const std::string &id = "");
 
   /** Draw text */
-  xmlNodePtr DrawText(const Text &text, xmlNodePtr parent_node = nullptr,
-                      const std::string &id = "");
+  Node DrawText(const Text &text, Node parent_node = {},
+                const std::string &id = "");
 
   /** Add a group node */
-  xmlNodePtr AddGroup(xmlNodePtr parent_node = nullptr,
-                      const std::string &id = "");
+  Node AddGroup(Node parent_node = {}, const std::string &id = "");
 
   /** Get the <defs> node */
-  xmlNodePtr Defs();
+  Node Defs();
+
+  /**
+   * @brief Select the layer that new elements are drawn into, creating it if
+   * needed. Layers are groups written in the order of their index, so each
+   * layer can be cleared and drawn again without affecting the others. Every
+   * layer has its own <defs>.
+   *
+   * Elements drawn before the first layer is selected stay below all layers.
+   */
+  void SelectLayer(std::size_t layer);
+
+  /** Remove all elements of a layer */
+  void ClearLayer(std::size_t layer);
 
 private:
-  unsigned int m_width, m_height;
+  friend Node AppendNode(Node parent, const std::string &name);
+  friend void SetAttribute(Node node, const std::string &name,
+                           const std::string &value, const std::string &unit);
+  friend void SetContent(Node node, const std::string &content);
+
+  Backend m_backend;
+  int m_precision = SHORTEST_PRECISION;
+  bool m_compact = false;
+  unsigned int m_width = 0, m_height = 0;
   xmlDocPtr m_doc = nullptr;
   xmlNodePtr m_root = nullptr;
   xmlNodePtr m_defs = nullptr;
+
+  /** Style declarations, indexed by the number of their class */
+  std::vector<std::string> m_styles;
+  std::unordered_map<std::string, std::size_t> m_style_classes;
+  /** The <style> element of the DOM backend */
+  xmlNodePtr m_style = nullptr;
+
+  /** A group of elements that can be drawn again independently */
+  struct Layer {
+    /** The group of the layer in the DOM backend */
+    xmlNodePtr node = nullptr;
+    xmlNodePtr defs = nullptr;
+    /** The serialized elements of the layer in the streaming backend, unless
+     * it is the selected layer, whose elements are in m_stream */
+    std::string stream;
+  };
+
+  std::vector<Layer> m_layers;
+  std::size_t m_layer = 0;
+
+  /** An element of the streaming backend whose end tag is still pending */
+  struct StreamElement {
+    std::size_t id;
+    std::string name;
+    std::size_t tag_offset;
+    bool tag_open;
+    std::string content;
+  };
+
+  static constexpr std::size_t STREAM_ROOT_ID = 0;
+
+  std::string m_stream;
+  std::string m_stream_root_attributes;
+  std::vector<StreamElement> m_stream_open;
+  std::size_t m_stream_next_id = STREAM_ROOT_ID + 1;
+  /** Elements streamed before the first layer was selected */
+  std::string m_stream_unlayered;
+
+  /** Returns the node new elements are appended to if no parent is given */
+  Node Root();
+
+  /** Returns the class of a style declaration, adding a rule if it is new */
+  std::string StyleClass(const std::string &declaration);
+
+  /** Returns the rules of the style sheet */
+  std::string StyleSheet() const;
+
+  /**
+   * @brief Add the styles of another document to this one.
+   *
+   * @return The class names in this document of the styles of the other one
+   */
+  std::vector<std::string> MergeStyles(const Document &document);
+
+  Node StreamOpen(Node parent, const std::string &name);
+  void StreamClose();
+  void StreamSetAttribute(std::size_t id, const std::string &name,
+                          const std::string &value);
+  void StreamSetContent(std::size_t id, const std::string &content);
+  Node AppendPath(const Path &path, Node parent_node, const std::string &id);
+  void SetPathData(Node node, const Path &path);
+  void SetPathData(Node node, const std::string &path_data);
+  std::string StreamClosingTags() const;
+  /** Write the elements of the streaming backend, all layers included */
+  void StreamWriteBody(const Writer &writer) const;
+  /** Returns the indentation depth of an element nested at some depth */
+  int StreamDepth(std::size_t depth) const;
+  void StreamIndent(std::string &out, std::size_t depth) const;
+  void StreamLineBreak(std::string &out) const;
 };
 
 } // namespace svg
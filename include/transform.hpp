@@ -0,0 +1,103 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PLOTCPP_INCLUDE_TRANSFORM_HPP_
+#define _PLOTCPP_INCLUDE_TRANSFORM_HPP_
+
+#include <cstddef>
+#include <span>
+
+#include "DataArray.hpp"
+#include "utility.hpp"
+
+namespace plotcpp {
+namespace transform {
+
+/**
+ * @brief Affine map from data values to frame coordinates:
+ * out = float(base + scale * (value - origin)) + offset
+ *
+ * The map is evaluated in Real precision and the offset is added in float
+ * precision, like the translations of single points.
+ */
+struct Affine {
+  Real origin;
+  Real scale;
+  Real base;
+  float offset;
+};
+
+/** Map a single value to frame coordinates */
+inline float Apply(const Affine &affine, Real value) {
+  return static_cast<float>(affine.base +
+                            affine.scale * (value - affine.origin)) +
+         affine.offset;
+}
+
+/**
+ * @brief Map a sequence of values of any numeric type to frame coordinates.
+ * Values are converted to Real in the same loop.
+ *
+ * @param affine Affine map
+ * @param values Values in their native type
+ * @param out Frame coordinates, with room for all values
+ */
+template <DataElement T>
+void Apply(const Affine &affine, std::span<const T> values, float *out) {
+  const std::size_t size = values.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = Apply(affine, static_cast<Real>(values[i]));
+  }
+}
+
+/**
+ * @brief Map a sequence of doubles to frame coordinates with AVX2 or NEON
+ * when they are available. The result is the same as mapping each value.
+ *
+ * @param affine Affine map
+ * @param values Values
+ * @param out Frame coordinates, with room for all values
+ */
+void Apply(const Affine &affine, std::span<const double> values, float *out);
+
+/**
+ * @brief Map a sequence of floats to frame coordinates with AVX2 or NEON
+ * when they are available. The result is the same as mapping each value.
+ *
+ * @param affine Affine map
+ * @param values Values
+ * @param out Frame coordinates, with room for all values
+ */
+void Apply(const Affine &affine, std::span<const float> values, float *out);
+
+/**
+ * @brief Map a range of the values of an array to frame coordinates.
+ *
+ * @param affine Affine map
+ * @param values Array of values
+ * @param first Index of the first value
+ * @param count Number of values
+ * @param out Frame coordinates, with room for count values
+ */
+void Apply(const Affine &affine, const DataArray &values, std::size_t first,
+           std::size_t count, float *out);
+
+} // namespace transform
+} // namespace plotcpp
+
+#endif // _PLOTCPP_INCLUDE_TRANSFORM_HPP_
@@ -66,7 +66,8 @@ template <typename T> Real Real(T x) { return static_cast<::plotcpp::Real>(x); }
  * @param v Vector
  * @return std::vector<Real> Conversion from T to Real
  */
-template <typename T> std::vector<::plotcpp::Real> Real(std::vector<T> v) {
+template <typename T>
+std::vector<::plotcpp::Real> Real(const std::vector<T> &v) {
   const std::size_t size = v.size();
 
   std::vector<::plotcpp::Real> real_vector;
@@ -239,6 +240,12 @@ const std::vector<Color> LIGHT{
     Color(0xFFAABB), Color(0x99DDFF), Color(0x44BB99),
     Color(0xBBCC33), Color(0xAAAA00), Color(0xDDDDDD)};
 
+/** Perceptually uniform colormap, from low to high values */
+const std::vector<Color> VIRIDIS{
+    Color(0x440154), Color(0x482878), Color(0x3E4A89), Color(0x31688E),
+    Color(0x26828E), Color(0x1F9E89), Color(0x35B779), Color(0x6DCD59),
+    Color(0xB4DE2C), Color(0xFDE725)};
+
 } // namespace color_tables
 
 class ColorSelector final {
@@ -21,6 +21,7 @@
 #include <fmt/format.h>
 
 #include <numeric>
+#include <utility>
 
 namespace plotcpp {
 
@@ -31,6 +32,34 @@ BarPlot::BarPlot() : m_color_selector(color_tables::VIBRANT) {
 
 void BarPlot::Plot(const std::vector<Real> &x_data,
                    const std::vector<Real> &y_data, const Color &color) {
+  PlotNumeric(std::vector<Real>(x_data), std::vector<Real>(y_data), color);
+}
+
+void BarPlot::Plot(const std::vector<Real> &x_data,
+                   const std::vector<Real> &y_data) {
+  Plot(x_data, y_data, m_color_selector.NextColor());
+}
+
+void BarPlot::Plot(const std::vector<std::string> &x_data,
+                   const std::vector<Real> &y_data, const Color &color) {
+  PlotCategorical(x_data, std::vector<Real>(y_data), color);
+}
+
+void BarPlot::Plot(const std::vector<std::string> &x_data,
+                   const std::vector<Real> &y_data) {
+  Plot(x_data, y_data, m_color_selector.NextColor());
+}
+
+void BarPlot::Plot(const std::vector<Real> &y_data, const Color &color) {
+  PlotValues(std::vector<Real>(y_data), color);
+}
+
+void BarPlot::Plot(const std::vector<Real> &y_data) {
+  Plot(y_data, m_color_selector.NextColor());
+}
+
+void BarPlot::PlotNumeric(std::vector<Real> &&x_data,
+                          std::vector<Real> &&y_data, const Color &color) {
   if (x_data.size() != y_data.size()) {
     return;
   }
@@ -48,18 +77,14 @@ void BarPlot::Plot(const std::vector<Real> &x_data,
   }
 
   m_data_type = DataType::NUMERIC;
-  m_numeric_x_data = x_data;
+  m_numeric_x_data = std::move(x_data);
   m_categorical_x_data.clear();
-  m_y_data.emplace_back(DataSeries{y_data, color});
+  m_y_data.emplace_back(DataSeries{std::move(y_data), color});
+  InvalidateData();
 }
 
-void BarPlot::Plot(const std::vector<Real> &x_data,
-                   const std::vector<Real> &y_data) {
-  Plot(x_data, y_data, m_color_selector.NextColor());
-}
-
-void BarPlot::Plot(const std::vector<std::string> &x_data,
-                   const std::vector<Real> &y_data, const Color &color) {
+void BarPlot::PlotCategorical(const std::vector<std::string> &x_data,
+                              std::vector<Real> &&y_data, const Color &color) {
   if (x_data.size() != y_data.size()) {
     return;
   }
@@ -79,15 +104,11 @@ void BarPlot::Plot(const std::vector<std::string> &x_data,
   m_data_type = DataType::CATEGORICAL;
   m_categorical_x_data = x_data;
   m_numeric_x_data.clear();
-  m_y_data.emplace_back(DataSeries{y_data, color});
+  m_y_data.emplace_back(DataSeries{std::move(y_data), color});
+  InvalidateData();
 }
 
-void BarPlot::Plot(const std::vector<std::string> &x_data,
-                   const std::vector<Real> &y_data) {
-  Plot(x_data, y_data, m_color_selector.NextColor());
-}
-
-void BarPlot::Plot(const std::vector<Real> &y_data, const Color &color) {
+void BarPlot::PlotValues(std::vector<Real> &&y_data, const Color &color) {
   if (m_y_data.size() == 0) {
     m_num_bars = y_data.size();
     m_numeric_x_data.clear();
@@ -104,32 +125,35 @@ void BarPlot::Plot(const std::vector<Real> &y_data, const Color &color) {
     }
   }
 
-  m_y_data.emplace_back(DataSeries{y_data, color});
-}
-
-void BarPlot::Plot(const std::vector<Real> &y_data) {
-  Plot(y_data, m_color_selector.NextColor());
+  m_y_data.emplace_back(DataSeries{std::move(y_data), color});
+  InvalidateData();
 }
 
 void BarPlot::SetXData(const std::vector<Real> &x_data) {
   m_numeric_x_data = x_data;
   m_data_type = DataType::NUMERIC;
+  Invalidate(Layer::FRAME);
 }
 
 void BarPlot::SetXData(const std::vector<std::string> &x_data) {
   m_categorical_x_data = x_data;
   m_data_type = DataType::CATEGORICAL;
+  Invalidate(Layer::FRAME);
 }
 
 void BarPlot::SetBaseline(Real baseline) {
   m_baselines = std::vector<Real>(m_num_bars, baseline);
+  Invalidate(Layer::DATA);
 }
 
 void BarPlot::SetBaselines(const std::vector<Real> &baselines) {
   m_baselines = baselines;
+  Invalidate(Layer::DATA);
 }
 
 void BarPlot::SetLegend(const std::vector<std::string> &labels) {
+  Invalidate(Layer::LEGEND);
+
   if (labels.empty()) {
     m_legend_labels.clear();
     return;
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <set>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -35,23 +36,42 @@
 namespace plotcpp {
 
 const std::string BarPlotBase::FRAME_RECT_CLIP_PATH_ID = {"rect-clip-path"};
+const std::string BarPlotBase::FRAME_RECT_CLIP_PATH_URL = {
+    "url(#rect-clip-path)"};
 
-void BarPlotBase::SetXLabel(const std::string &label) { m_x_label = label; }
+void BarPlotBase::SetXLabel(const std::string &label) {
+  m_x_label = label;
+  Invalidate(Layer::LABELS);
+}
 
-void BarPlotBase::SetYLabel(const std::string &label) { m_y_label = label; }
+void BarPlotBase::SetYLabel(const std::string &label) {
+  m_y_label = label;
+  Invalidate(Layer::LABELS);
+}
 
-void BarPlotBase::SetGrid(bool enable) { m_grid_enable = enable; }
+void BarPlotBase::SetGrid(bool enable) {
+  m_grid_enable = enable;
+  Invalidate(Layer::FRAME);
+}
 
-void BarPlotBase::SetRoundedEdges(bool enable) { m_rounded_borders = enable; }
+void BarPlotBase::SetRoundedEdges(bool enable) {
+  m_rounded_borders = enable;
+  Invalidate(Layer::DATA);
+}
 
 void BarPlotBase::SetBarRelativeWidth(float rel_width) {
   m_bar_width_rel = std::max(0.0f, std::min(1.0f, rel_width));
+  Invalidate(Layer::DATA);
 }
 
-void BarPlotBase::AddYMarker(Real marker) { m_y_custom_markers.insert(marker); }
+void BarPlotBase::AddYMarker(Real marker) {
+  m_y_custom_markers.insert(marker);
+  Invalidate(Layer::FRAME);
+}
 
 void BarPlotBase::SetLegend(const std::vector<std::string> &labels) {
   m_legend_labels = labels;
+  Invalidate(Layer::LEGEND);
 }
 
 void BarPlotBase::Clear() {
@@ -59,6 +79,7 @@ void BarPlotBase::Clear() {
 
   m_x_label.clear();
   m_y_label.clear();
+  Invalidate(Layer::LABELS);
 }
 
 void BarPlotBase::ClearData() {
@@ -66,25 +87,50 @@ void BarPlotBase::ClearData() {
   m_numeric_x_data.clear();
   m_categorical_x_data.clear();
   m_y_data.clear();
+  InvalidateData();
+}
+
+void BarPlotBase::InvalidateData() {
+  Invalidate(Layer::FRAME);
+  Invalidate(Layer::DATA);
+  Invalidate(Layer::LEGEND);
 }
 
 void BarPlotBase::Build() {
-  m_svg.Reset();
   m_svg.SetSize(m_width, m_height);
+  m_rebuilt_layers.reset();
 
+  // The y axis changes with the bars and their baselines
+  const auto y_range = m_y_range;
   CalculateFrame();
+  if (m_y_range != y_range) {
+    Invalidate(Layer::FRAME);
+    Invalidate(Layer::DATA);
+  }
 
-  DrawBackground();
-  DrawTitle();
-  DrawLabels();
-  DrawFrame();
-  DrawBars();
-  DrawLegend();
+  if (BeginLayer(Layer::BACKGROUND)) {
+    DrawBackground();
+  }
+  if (BeginLayer(Layer::TITLE)) {
+    DrawTitle();
+  }
+  if (BeginLayer(Layer::FRAME)) {
+    DrawFrame();
+  }
+  if (BeginLayer(Layer::LABELS)) {
+    DrawLabels();
+  }
+  if (BeginLayer(Layer::DATA)) {
+    DrawBars();
+  }
+  if (BeginLayer(Layer::LEGEND)) {
+    DrawLegend();
+  }
 }
 
-float BarPlotBase::TranslateToFrame(Real y) const {
-  return (BAR_FRAME_Y_MARGIN_REL * m_frame_h) -
-         (m_zoom_y * static_cast<float>(y - m_y_range.second));
+transform::Affine BarPlotBase::FrameTransformY() const {
+  return {m_y_range.second, -m_zoom_y, BAR_FRAME_Y_MARGIN_REL * m_frame_h,
+          0.0f};
 }
 
 void BarPlotBase::CalculateFrame() {
@@ -166,31 +212,57 @@ void BarPlotBase::DrawBars() {
     }
   }
 
+  auto data_layer = m_svg.AddGroup();
+  svg::SetAttribute(data_layer, "clip-path", FRAME_RECT_CLIP_PATH_URL);
+
+  // The heights of the whole bars do not depend on the series
+  const transform::Affine to_frame_y = FrameTransformY();
+  std::vector<float> frame_baselines(m_num_bars);
+  std::vector<float> frame_positive_sizes(m_num_bars);
+  std::vector<float> frame_negative_sizes(m_num_bars);
+  transform::Apply(to_frame_y, std::span<const Real>(m_baselines),
+                   frame_baselines.data());
+  transform::Apply(to_frame_y, std::span<const Real>(positive_bar_sizes),
+                   frame_positive_sizes.data());
+  transform::Apply(to_frame_y, std::span<const Real>(negative_bar_sizes),
+                   frame_negative_sizes.data());
+
+  // The segment of each series starts where the previous ones ended, on the
+  // side of the baseline given by the sign of its value
+  transform::Affine to_image_y = to_frame_y;
+  to_image_y.offset = m_frame_y;
   std::vector<Real> pos_acc(m_num_bars, 0.0f);
   std::vector<Real> neg_acc(m_num_bars, 0.0f);
+  std::vector<Real> segment_start(m_num_bars);
+  std::vector<Real> segment_end(m_num_bars);
+  std::vector<float> start_y(m_num_bars);
+  std::vector<float> end_y(m_num_bars);
   for (const auto &series : m_y_data) {
+    auto series_node = m_svg.AddGroup(data_layer);
+
+    for (std::size_t i = 0; i < m_num_bars; ++i) {
+      const Real value = series.values[i];
+      const Real acc = (value > 0) ? pos_acc[i] : neg_acc[i];
+      segment_start[i] = m_baselines[i] + acc;
+      segment_end[i] = m_baselines[i] + acc + value;
+    }
+    transform::Apply(to_image_y, std::span<const Real>(segment_start),
+                     start_y.data());
+    transform::Apply(to_image_y, std::span<const Real>(segment_end),
+                     end_y.data());
+
     for (std::size_t i = 0; i < m_num_bars; ++i) {
       const Real value = series.values[i];
 
-      float start_y;
-      float end_y;
       bool should_round_border = m_rounded_borders;
       Real bar_height = 0.0f;
       if (value > 0) {
-        start_y = m_frame_y + TranslateToFrame(m_baselines[i] + pos_acc[i]);
-        end_y =
-            m_frame_y + TranslateToFrame(m_baselines[i] + pos_acc[i] + value);
         pos_acc[i] += value;
-        bar_height = TranslateToFrame(positive_bar_sizes[i]) -
-                     TranslateToFrame(m_baselines[i]);
+        bar_height = frame_positive_sizes[i] - frame_baselines[i];
         should_round_border &= (--remaining_positive_segment_counts[i] == 0);
       } else if (value < 0) {
-        start_y = m_frame_y + TranslateToFrame(m_baselines[i] + neg_acc[i]);
-        end_y =
-            m_frame_y + TranslateToFrame(m_baselines[i] + neg_acc[i] + value);
         neg_acc[i] += value;
-        bar_height = TranslateToFrame(negative_bar_sizes[i]) -
-                     TranslateToFrame(m_baselines[i]);
+        bar_height = frame_negative_sizes[i] - frame_baselines[i];
         should_round_border &= (--remaining_negative_segment_counts[i] == 0);
       } else {
         continue;
@@ -208,41 +280,34 @@ void BarPlotBase::DrawBars() {
 
       should_round_border &= (std::abs(bar_height) >= std::abs(delta));
 
-      std::vector<svg::PathCommand> cmds =
-          (!should_round_border)
-              ? std::vector<
-                    svg::PathCommand>{{svg::PathCommand::Id::MOVE,
-                                       {bar_center_x - (bar_width / 2.0f),
-                                        start_y}},
-                                      {svg::PathCommand::Id::VERTICAL, {end_y}},
-                                      {svg::PathCommand::Id::HORIZONTAL_R,
-                                       {bar_width}},
-                                      {svg::PathCommand::Id::VERTICAL,
-                                       {start_y}},
-                                      {svg::PathCommand::Id::CLOSE, {}}}
-              : std::vector<svg::PathCommand>{
-                    {svg::PathCommand::Id::MOVE,
-                     {bar_center_x - (bar_width / 2.0f), start_y}},
-                    {svg::PathCommand::Id::VERTICAL, {end_y - delta}},
-                    {svg::PathCommand::Id::QUADRATIC_R,
-                     {0, delta, std::abs(delta), delta}},
-                    {svg::PathCommand::Id::HORIZONTAL,
-                     {bar_center_x + bar_width / 2.0f - std::abs(delta)}},
-                    {svg::PathCommand::Id::QUADRATIC_R,
-                     {std::abs(delta), 0, std::abs(delta), -delta}},
-                    {svg::PathCommand::Id::VERTICAL, {start_y}},
-                    {svg::PathCommand::Id::CLOSE, {}}};
-
-      svg::Path path{
-          .commands = cmds,
-          .stroke_width = 1.0f,
-          .stroke_color = series.color,
-          .stroke_opacity = 1.0f,
-          .fill_color = series.color,
-          .fill_opacity = 1.0f,
-          .fill_transparent = false,
-      };
-      m_svg.DrawPath(path);
+      svg::Path path;
+      path.stroke_width = 1.0f;
+      path.stroke_color = series.color;
+      path.stroke_opacity = 1.0f;
+      path.fill_color = series.color;
+      path.fill_opacity = 1.0f;
+      path.fill_transparent = false;
+
+      using Id = svg::PathCommand::Id;
+      const float bar_left_x = bar_center_x - (bar_width / 2.0f);
+      if (!should_round_border) {
+        path.Add(Id::MOVE, {bar_left_x, start_y[i]});
+        path.Add(Id::VERTICAL, {end_y[i]});
+        path.Add(Id::HORIZONTAL_R, {bar_width});
+        path.Add(Id::VERTICAL, {start_y[i]});
+        path.Add(Id::CLOSE, {});
+      } else {
+        path.Add(Id::MOVE, {bar_left_x, start_y[i]});
+        path.Add(Id::VERTICAL, {end_y[i] - delta});
+        path.Add(Id::QUADRATIC_R, {0, delta, std::abs(delta), delta});
+        path.Add(Id::HORIZONTAL,
+                 {bar_center_x + bar_width / 2.0f - std::abs(delta)});
+        path.Add(Id::QUADRATIC_R,
+                 {std::abs(delta), 0, std::abs(delta), -delta});
+        path.Add(Id::VERTICAL, {start_y[i]});
+        path.Add(Id::CLOSE, {});
+      }
+      m_svg.DrawPath(path, series_node);
     }
   }
 }
@@ -269,11 +334,9 @@ void BarPlotBase::DrawLabels() {
         svg::Text{m_y_label, 0, 0, m_axis_font_size, components::TEXT_FONT});
     svg::SetAttribute(node_ptr, "text-anchor", "middle");
 
-    std::stringstream trans_ss;
-    trans_ss << "translate(" << std::to_string(x) << ", " << std::to_string(y)
-             << ") "
-             << "rotate(-90)";
-    svg::SetAttribute(node_ptr, "transform", trans_ss.str());
+    const std::string transform = "translate(" + m_svg.FormatNumber(x) + ", " +
+                                  m_svg.FormatNumber(y) + ") rotate(-90)";
+    svg::SetAttribute(node_ptr, "transform", transform);
   }
 }
 
@@ -290,7 +353,7 @@ void BarPlotBase::DrawFrame() {
       continue;
     }
 
-    const auto y = TranslateToFrame(marker);
+    const auto y = transform::Apply(FrameTransformY(), marker);
     const std::string marker_text =
         (!m_round_y_markers)
             ? fmt::format("{:.2f}", marker)
@@ -50,10 +50,19 @@ cairo_surface_t *DisplayService::RenderToSurface(const Figure *figure) const {
   const int width = static_cast<int>(figure->Width());
   const int height = static_cast<int>(figure->Height());
 
-  const std::string svg_str = figure->GetSVGText();
-  const uint8_t *svg_data = (const uint8_t *)(svg_str.c_str());
-  RsvgHandle *handle =
-      rsvg_handle_new_from_data(svg_data, svg_str.size(), nullptr);
+  // The document is fed to librsvg in chunks as it is written
+  GInputStream *svg_stream = g_memory_input_stream_new();
+  figure->WriteSVG([svg_stream](const char *data, std::size_t size) {
+    GBytes *bytes = g_bytes_new(data, size);
+    g_memory_input_stream_add_bytes(G_MEMORY_INPUT_STREAM(svg_stream), bytes);
+    g_bytes_unref(bytes);
+  });
+  RsvgHandle *handle = rsvg_handle_new_from_stream_sync(
+      svg_stream, nullptr, RSVG_HANDLE_FLAGS_NONE, nullptr, nullptr);
+  g_object_unref(svg_stream);
+  if (handle == nullptr) {
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+  }
 
   cairo_surface_t *surface =
       cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
@@ -69,6 +78,7 @@ cairo_surface_t *DisplayService::RenderToSurface(const Figure *figure) const {
   rsvg_handle_render_document(handle, cr, &viewport, nullptr);
 
   cairo_destroy(cr);
+  g_object_unref(handle);
 
   return surface;
 }
@@ -19,8 +19,13 @@
 #include "Figure.hpp"
 
 #include <librsvg/rsvg.h>
+#include <unistd.h>
+#include <zlib.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <fstream>
+#include <limits>
 #include <string>
 #include <thread>
 
@@ -28,13 +33,23 @@
 
 namespace plotcpp {
 
-void Figure::SetTitle(const std::string &title) { m_title = title; }
+Figure::Figure() { InvalidateAll(); }
+
+void Figure::SetTitle(const std::string &title) {
+  m_title = title;
+  Invalidate(Layer::TITLE);
+}
 
 std::string Figure::Title() const { return m_title; }
 
 void Figure::SetSize(unsigned int width, unsigned int height) {
+  if ((width == m_width) && (height == m_height)) {
+    return;
+  }
+
   m_width = width;
   m_height = height;
+  InvalidateAll();
 }
 
 unsigned int Figure::Width() const { return m_width; }
@@ -43,8 +58,84 @@ unsigned int Figure::Height() const { return m_height; }
 
 std::string Figure::GetSVGText() const { return m_svg.GetText(); }
 
+void Figure::WriteSVG(const svg::Document::Writer &writer) const {
+  m_svg.Write(writer);
+}
+
+void Figure::WriteSVG(std::ostream &out) const {
+  m_svg.Write([&out](const char *data, std::size_t size) {
+    out.write(data, static_cast<std::streamsize>(size));
+  });
+}
+
+void Figure::WriteSVG(std::FILE *file) const {
+  m_svg.Write([file](const char *data, std::size_t size) {
+    std::fwrite(data, 1, size, file);
+  });
+}
+
+bool Figure::WriteSVG(int fd) const {
+  bool failed = false;
+  m_svg.Write([fd, &failed](const char *data, std::size_t size) {
+    while (!failed && (size > 0)) {
+      const ssize_t written = ::write(fd, data, size);
+      if (written < 0) {
+        failed = (errno != EINTR);
+        continue;
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    }
+  });
+  return !failed;
+}
+
 svg::Document &Figure::GetSVGDocument() { return m_svg; }
 
+void Figure::SetSVGBackend(svg::Document::Backend backend) {
+  m_svg.SetBackend(backend);
+  InvalidateAll();
+}
+
+void Figure::SetSVGPrecision(int precision) {
+  m_svg.SetPrecision(precision);
+  InvalidateAll();
+}
+
+void Figure::SetSVGCompact(bool compact) {
+  m_svg.SetCompact(compact);
+  InvalidateAll();
+}
+
+std::vector<Figure::Layer> Figure::GetRebuiltLayers() const {
+  std::vector<Layer> layers;
+  for (std::size_t i = 0; i < NUM_LAYERS; ++i) {
+    if (m_rebuilt_layers.test(i)) {
+      layers.push_back(static_cast<Layer>(i));
+    }
+  }
+  return layers;
+}
+
+void Figure::Invalidate(Layer layer) {
+  m_invalid_layers.set(static_cast<std::size_t>(layer));
+}
+
+void Figure::InvalidateAll() { m_invalid_layers.set(); }
+
+bool Figure::BeginLayer(Layer layer) {
+  const auto index = static_cast<std::size_t>(layer);
+  if (!m_invalid_layers.test(index)) {
+    return false;
+  }
+
+  m_svg.SelectLayer(index);
+  m_svg.ClearLayer(index);
+  m_invalid_layers.reset(index);
+  m_rebuilt_layers.set(index);
+  return true;
+}
+
 void Figure::Show() const {
   const DisplayService &display_service = DisplayService::GetInstance();
   display_service.ShowFigure(this);
@@ -57,7 +148,9 @@ void Figure::Show() const {
 void Figure::Save(const std::string &filepath) const {
   // TODO: Extract extension and call save function
   auto ext = filepath.find_last_of(".") + 1;
-  if (filepath.substr(ext) == "svg") {
+  if (filepath.ends_with(".svgz") || filepath.ends_with(".svg.gz")) {
+    SaveSVGZ(filepath);
+  } else if (filepath.substr(ext) == "svg") {
     SaveSVG(filepath);
   } else if (filepath.substr(ext) == "png") {
     const DisplayService &display_service = DisplayService::GetInstance();
@@ -71,8 +164,27 @@ void Figure::Save(const std::string &filepath) const {
 
 void Figure::SaveSVG(const std::string &filepath) const {
   std::ofstream out_file(filepath);
-  out_file << m_svg.GetText();
+  WriteSVG(out_file);
   out_file.close();
 }
 
+void Figure::SaveSVGZ(const std::string &filepath) const {
+  gzFile out_file = gzopen(filepath.c_str(), "wb");
+  if (out_file == nullptr) {
+    return;
+  }
+
+  WriteSVG([out_file](const char *data, std::size_t size) {
+    // gzwrite takes the length as an unsigned int
+    while (size > 0) {
+      const auto chunk_size = static_cast<unsigned int>(
+          std::min<std::size_t>(size, std::numeric_limits<int>::max()));
+      gzwrite(out_file, data, chunk_size);
+      data += chunk_size;
+      size -= chunk_size;
+    }
+  });
+  gzclose(out_file);
+}
+
 } // namespace plotcpp
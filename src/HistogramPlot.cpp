@@ -19,6 +19,8 @@
 #include "HistogramPlot.hpp"
 
 #include <algorithm>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "utility.hpp"
@@ -35,6 +37,11 @@ void HistogramPlot::Clear() { ClearData(); }
 
 void HistogramPlot::Plot(const std::vector<Real> &values, unsigned int num_bins,
                          const Color &color) {
+  PlotValues(DataArray(std::span<const Real>(values)), num_bins, color);
+}
+
+void HistogramPlot::PlotValues(const DataArray &values, unsigned int num_bins,
+                               const Color &color) {
   ClearData();
 
   std::vector<Real> intervals = CalculateIntervals(values, num_bins);
@@ -43,17 +50,20 @@ void HistogramPlot::Plot(const std::vector<Real> &values, unsigned int num_bins,
   m_num_bars = m_numeric_x_data.size();
   m_y_data.push_back(DataSeries{counts, color});
   m_data_type = DataType::NUMERIC;
+  InvalidateData();
 }
 
 std::vector<Real>
-HistogramPlot::CalculateIntervals(const std::vector<Real> &values,
+HistogramPlot::CalculateIntervals(const DataArray &values,
                                   unsigned int num_bins) {
   std::vector<Real> intervals;
   intervals.resize(num_bins + 1);
 
-  const auto [min, max] =
-      std::pair<Real, Real>{*std::min_element(values.begin(), values.end()),
-                            *std::max_element(values.begin(), values.end())};
+  const auto [min, max] = values.Visit([](auto view) {
+    return std::pair<Real, Real>{
+        static_cast<Real>(*std::min_element(view.begin(), view.end())),
+        static_cast<Real>(*std::max_element(view.begin(), view.end()))};
+  });
 
   if (min == max) {
     return {min};
@@ -93,7 +103,7 @@ HistogramPlot::CalculateBins(const std::vector<Real> &intervals) {
 }
 
 std::vector<Real>
-HistogramPlot::CalculateHistogram(const std::vector<Real> &values,
+HistogramPlot::CalculateHistogram(const DataArray &values,
                                   const std::vector<Real> &intervals) {
   if (intervals.size() == 0) {
     return {};
@@ -102,12 +112,15 @@ HistogramPlot::CalculateHistogram(const std::vector<Real> &values,
   const std::size_t num_bins = intervals.size() - 1;
   std::vector<std::size_t> counts(num_bins, 0);
 
-  for (const auto &value : values) {
-    const auto [index, found] = BinarySearchInterval(value, intervals);
-    if (found) {
-      ++counts[index];
+  values.Visit([&](auto view) {
+    for (const auto value : view) {
+      const auto [index, found] =
+          BinarySearchInterval(static_cast<Real>(value), intervals);
+      if (found) {
+        ++counts[index];
+      }
     }
-  }
+  });
 
   return adaptor::Real(counts);
 }
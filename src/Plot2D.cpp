@@ -21,17 +21,28 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <optional>
+#include <set>
+#include <span>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "clipping.hpp"
 #include "components/Frame.hpp"
 #include "components/Legend.hpp"
+#include "density.hpp"
 #include "fonts.hpp"
+#include "png.hpp"
+#include "reduction.hpp"
+#include "sampling.hpp"
 #include "svg.hpp"
 #include "utility.hpp"
 
@@ -42,7 +53,72 @@ template <typename T> static bool IsInfinity(T x) {
          (x == -std::numeric_limits<T>::infinity());
 }
 
+/** Convert an owned array to T unless its values already are of type T */
+template <DataElement T> static bool ConvertArray(DataArray &array) {
+  const bool is_converted = array.Visit([](auto view) {
+    return std::is_same_v<decltype(view), std::span<const T>>;
+  });
+  if (!array.IsOwned() || is_converted) {
+    return false;
+  }
+
+  array = array.Convert<T>();
+  return true;
+}
+
+/**
+ * Share a budget of points between polylines in proportion to their size, so
+ * that the budgets add up to at most the total. Every polyline keeps its
+ * first and last points, and if there are too many polylines for that, only
+ * the largest ones get a budget. The rest of the budget is split with the
+ * largest remainder method. Polylines with a budget of 0 are dropped.
+ */
+static std::vector<std::size_t>
+ShareBudget(const std::vector<std::size_t> &sizes, std::size_t max_points) {
+  max_points = std::max<std::size_t>(max_points, 2);
+
+  std::vector<std::size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) {
+                     return sizes[a] > sizes[b];
+                   });
+  order.resize(std::min(order.size(), max_points / 2));
+
+  std::vector<std::size_t> budgets(sizes.size(), 0);
+  std::size_t spare = max_points;
+  std::size_t extra_points = 0;
+  for (const std::size_t i : order) {
+    budgets[i] = std::min<std::size_t>(sizes[i], 2);
+    spare -= budgets[i];
+    extra_points += sizes[i] - budgets[i];
+  }
+  if (spare >= extra_points) {
+    for (const std::size_t i : order) {
+      budgets[i] = sizes[i];
+    }
+    return budgets;
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> remainders;
+  std::size_t shared = 0;
+  for (const std::size_t i : order) {
+    const std::size_t share = spare * (sizes[i] - budgets[i]);
+    budgets[i] += share / extra_points;
+    shared += share / extra_points;
+    remainders.emplace_back(share % extra_points, i);
+  }
+  std::stable_sort(
+      remainders.begin(), remainders.end(),
+      [](const auto &a, const auto &b) { return a.first > b.first; });
+  for (std::size_t j = 0; j < spare - shared; ++j) {
+    ++budgets[remainders[j].second];
+  }
+  return budgets;
+}
+
 const std::string Plot2D::FRAME_RECT_CLIP_PATH_ID = {"rect-clip-path"};
+const std::string Plot2D::FRAME_RECT_CLIP_PATH_URL = {"url(#rect-clip-path)"};
 
 Plot2D::Plot2D() : Figure(), m_color_selector(color_tables::BRIGHT) {}
 
@@ -53,15 +129,8 @@ void Plot2D::Plot(const std::vector<Real> &x_data,
     return;
   }
 
-  if (m_hold == false) {
-    m_numeric_data.clear();
-  }
-
-  const Style style = {color, stroke_width, dash_array, false};
-  m_numeric_data.emplace_back(DataSeries{x_data, y_data, style});
-
-  m_data_type = DataType::NUMERIC;
-  m_categorical_data.clear();
+  Plot(std::vector<Real>(x_data), std::vector<Real>(y_data), color,
+       stroke_width, dash_array);
 }
 
 void Plot2D::Plot(const std::vector<Real> &x_data,
@@ -70,21 +139,50 @@ void Plot2D::Plot(const std::vector<Real> &x_data,
   Plot(x_data, y_data, m_color_selector.NextColor(), stroke_width, dash_array);
 }
 
+void Plot2D::Plot(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+                  const Color &color, const float stroke_width,
+                  const std::string &dash_array) {
+  PlotNumeric(DataArray(std::move(x_data)), DataArray(std::move(y_data)),
+              color, stroke_width, dash_array);
+}
+
+void Plot2D::Plot(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+                  const float stroke_width, const std::string &dash_array) {
+  Plot(std::move(x_data), std::move(y_data), m_color_selector.NextColor(),
+       stroke_width, dash_array);
+}
+
+void Plot2D::Plot(std::span<const Real> x_data, std::span<const Real> y_data,
+                  const Color &color, const float stroke_width,
+                  const std::string &dash_array) {
+  PlotNumeric(DataArray(x_data), DataArray(y_data), color, stroke_width,
+              dash_array);
+}
+
+void Plot2D::Plot(std::span<const Real> x_data, std::span<const Real> y_data,
+                  const float stroke_width, const std::string &dash_array) {
+  Plot(x_data, y_data, m_color_selector.NextColor(), stroke_width, dash_array);
+}
+
 void Plot2D::Plot(const std::vector<Real> &y_data, const Color &color,
                   const float stroke_width, const std::string &dash_array) {
   if (m_data_type == DataType::NUMERIC) {
     std::vector<Real> x_data;
     x_data.resize(y_data.size());
     std::iota(x_data.begin(), x_data.end(), 1.0f);
-    Plot(x_data, y_data, color, stroke_width, dash_array);
+    Plot(std::move(x_data), std::vector<Real>(y_data), color, stroke_width,
+         dash_array);
   } else if (m_data_type == DataType::CATEGORICAL) {
     if ((m_categorical_labels.size() > 0) &&
         (m_categorical_labels.size() != y_data.size())) {
       return;
     }
 
-    const Style style = {color, stroke_width, dash_array, false};
-    m_categorical_data.emplace_back(CategoricalDataSeries{y_data, style});
+    const Style style = {color, stroke_width, dash_array, false,
+                         m_simplification, m_decimation, m_max_points};
+    m_categorical_data.emplace_back(
+      CategoricalDataSeries{y_data, style, reduction::FiniteRange(y_data)});
+    InvalidateData();
   }
 }
 
@@ -96,8 +194,9 @@ void Plot2D::Plot(const std::vector<Real> &y_data, const float stroke_width,
 void Plot2D::Plot(const std::vector<Real> &x_data,
                   const std::function<Real(Real)> &function, const Color &color,
                   const float stroke_width, const std::string &dash_array) {
-  const auto y_data = ranges::Generate(x_data, function);
-  Plot(x_data, y_data, color, stroke_width, dash_array);
+  auto y_data = ranges::Generate(x_data, function);
+  Plot(std::vector<Real>(x_data), std::move(y_data), color, stroke_width,
+       dash_array);
 }
 
 void Plot2D::Plot(const std::vector<Real> &x_data,
@@ -126,10 +225,14 @@ void Plot2D::Plot(const std::vector<std::string> &x_data,
   m_categorical_data.clear();
   m_categorical_labels = x_data;
 
-  const Style style = {color, stroke_width, dash_array, false};
-  m_categorical_data.emplace_back(CategoricalDataSeries{y_data, style});
+  const Style style = {color, stroke_width, dash_array, false,
+                       m_simplification, m_decimation, m_max_points};
+  m_categorical_data.emplace_back(
+      CategoricalDataSeries{y_data, style, reduction::FiniteRange(y_data)});
   m_numeric_data.clear();
   m_data_type = DataType::CATEGORICAL;
+  InvalidateData();
+  Invalidate(Layer::FRAME);
 }
 
 void Plot2D::Plot(const std::vector<std::string> &x_data,
@@ -145,15 +248,7 @@ void Plot2D::Scatter(const std::vector<Real> &x_data,
     return;
   }
 
-  if (m_hold == false) {
-    m_numeric_data.clear();
-  }
-
-  const Style style = {color, radius, "", true};
-  m_numeric_data.emplace_back(DataSeries{x_data, y_data, style});
-
-  m_data_type = DataType::NUMERIC;
-  m_categorical_data.clear();
+  Scatter(std::vector<Real>(x_data), std::vector<Real>(y_data), color, radius);
 }
 
 void Plot2D::Scatter(const std::vector<Real> &x_data,
@@ -161,6 +256,29 @@ void Plot2D::Scatter(const std::vector<Real> &x_data,
   Scatter(x_data, y_data, m_color_selector.NextColor(), radius);
 }
 
+void Plot2D::Scatter(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+                     const Color &color, const float radius) {
+  ScatterNumeric(DataArray(std::move(x_data)), DataArray(std::move(y_data)),
+                 color, radius);
+}
+
+void Plot2D::Scatter(std::vector<Real> &&x_data, std::vector<Real> &&y_data,
+                     const float radius) {
+  Scatter(std::move(x_data), std::move(y_data), m_color_selector.NextColor(),
+          radius);
+}
+
+void Plot2D::Scatter(std::span<const Real> x_data,
+                     std::span<const Real> y_data, const Color &color,
+                     const float radius) {
+  ScatterNumeric(DataArray(x_data), DataArray(y_data), color, radius);
+}
+
+void Plot2D::Scatter(std::span<const Real> x_data,
+                     std::span<const Real> y_data, const float radius) {
+  Scatter(x_data, y_data, m_color_selector.NextColor(), radius);
+}
+
 void Plot2D::Scatter(const std::vector<std::string> &x_data,
                      const std::vector<Real> &y_data, const Color &color,
                      const float radius) {
@@ -175,10 +293,14 @@ void Plot2D::Scatter(const std::vector<std::string> &x_data,
     m_categorical_labels = x_data;
   }
 
-  const Style style = {color, radius, "", true};
-  m_categorical_data.emplace_back(CategoricalDataSeries{y_data, style});
+  const Style style = {color, radius, "", true, m_simplification,
+                       m_decimation, m_max_points};
+  m_categorical_data.emplace_back(
+      CategoricalDataSeries{y_data, style, reduction::FiniteRange(y_data)});
   m_numeric_data.clear();
   m_data_type = DataType::CATEGORICAL;
+  InvalidateData();
+  Invalidate(Layer::FRAME);
 }
 
 void Plot2D::Scatter(const std::vector<std::string> &x_data,
@@ -206,23 +328,215 @@ std::optional<ranges::Interval<Real>> Plot2D::GetYRange() const {
   return m_y_set_range;
 }
 
-void Plot2D::SetXLabel(const std::string &label) { m_x_label = label; }
+void Plot2D::SetXLabel(const std::string &label) {
+  m_x_label = label;
+  Invalidate(Layer::LABELS);
+}
 
-void Plot2D::SetYLabel(const std::string &label) { m_y_label = label; }
+void Plot2D::SetYLabel(const std::string &label) {
+  m_y_label = label;
+  Invalidate(Layer::LABELS);
+}
 
 std::string Plot2D::GetXLabel() const { return m_x_label; }
 
 std::string Plot2D::GetYLabel() const { return m_y_label; }
 
-void Plot2D::AddXMarker(Real x) { m_x_custom_markers.insert(x); }
+void Plot2D::AddXMarker(Real x) {
+  m_x_custom_markers.insert(x);
+  Invalidate(Layer::FRAME);
+}
+
+void Plot2D::AddYMarker(Real y) {
+  m_y_custom_markers.insert(y);
+  Invalidate(Layer::FRAME);
+}
+
+void Plot2D::SetGrid(bool enable) {
+  m_grid_enable = enable;
+  Invalidate(Layer::FRAME);
+}
+
+Plot2D::SeriesHandle Plot2D::PlotStream(std::size_t capacity,
+                                        const Color &color,
+                                        const float stroke_width,
+                                        const std::string &dash_array) {
+  auto stream = std::make_shared<StreamBuffer>(capacity);
+  PlotNumeric(DataArray(stream->X()), DataArray(stream->Y()), color,
+              stroke_width, dash_array);
+  m_numeric_data.back().stream = stream;
+  return stream;
+}
+
+Plot2D::SeriesHandle Plot2D::PlotStream(std::size_t capacity,
+                                        const float stroke_width,
+                                        const std::string &dash_array) {
+  return PlotStream(capacity, m_color_selector.NextColor(), stroke_width,
+                    dash_array);
+}
+
+void Plot2D::Append(SeriesHandle series, Real x, Real y) {
+  Append(series, std::span<const Real>(&x, 1), std::span<const Real>(&y, 1));
+}
+
+void Plot2D::Append(SeriesHandle series, std::span<const Real> x_data,
+                    std::span<const Real> y_data) {
+  const auto stream = series.lock();
+  if (!stream || (x_data.size() != y_data.size())) {
+    return;
+  }
+  const auto it = std::find_if(
+      m_numeric_data.begin(), m_numeric_data.end(),
+      [&stream](const auto &plot) { return plot.stream == stream; });
+  if (it == m_numeric_data.end()) {
+    return;
+  }
+
+  auto &plot = *it;
+  plot.stream->Append(x_data, y_data);
+  plot.x = DataArray(plot.stream->X());
+  plot.y = DataArray(plot.stream->Y());
+  plot.x_range = plot.stream->XRange();
+  plot.y_range = plot.stream->YRange();
+  plot.x_sorted = plot.stream->IsXSorted();
+  InvalidateData();
+}
+
+void Plot2D::PlotGenerator(const std::function<Real(Real)> &generator,
+                          const Color &color, const float stroke_width,
+                          const std::string &dash_array) {
+  AddGenerator(generator, std::nullopt, color, stroke_width, dash_array);
+}
+
+void Plot2D::PlotGenerator(const std::function<Real(Real)> &generator,
+                          const float stroke_width,
+                          const std::string &dash_array) {
+  PlotGenerator(generator, m_color_selector.NextColor(), stroke_width,
+                dash_array);
+}
 
-void Plot2D::AddYMarker(Real y) { m_y_custom_markers.insert(y); }
+void Plot2D::AddGenerator(const std::function<Real(Real)> &function,
+                          const std::optional<ranges::Interval<Real>> &domain,
+                          const Color &color, const float stroke_width,
+                          const std::string &dash_array) {
+  if (!function) {
+    return;
+  }
 
-void Plot2D::SetGrid(bool enable) { m_grid_enable = enable; }
+  PlotNumeric(DataArray(), DataArray(), color, stroke_width, dash_array);
+  DataSeries &plot = m_numeric_data.back();
+  plot.generator = std::make_shared<Generator>(
+      Generator{function, domain, {}, {}, reduction::EMPTY_RANGE, 0, 0});
+  if (domain.has_value()) {
+    plot.x_range = domain.value();
+  }
+}
 
 void Plot2D::SetHold(bool hold) { m_hold = hold; }
 
+void Plot2D::SetScatterMode(ScatterMode mode) {
+  m_scatter_mode = mode;
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetOverdrawElimination(bool enable, std::size_t subpixels) {
+  m_overdraw_subpixels = enable ? subpixels : 0;
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetSimplification(Simplification method, float tolerance) {
+  m_simplification = {method, tolerance};
+  for (auto &plot : m_numeric_data) {
+    plot.style.simplification = m_simplification;
+  }
+  for (auto &plot : m_categorical_data) {
+    plot.style.simplification = m_simplification;
+  }
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetSimplification(std::size_t series, Simplification method,
+                               float tolerance) {
+  if (series >= m_numeric_data.size()) {
+    return;
+  }
+
+  m_numeric_data[series].style.simplification = {method, tolerance};
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetDecimation(Decimation method, float threshold) {
+  m_decimation = {method, threshold};
+  for (auto &plot : m_numeric_data) {
+    plot.style.decimation = m_decimation;
+  }
+  for (auto &plot : m_categorical_data) {
+    plot.style.decimation = m_decimation;
+  }
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetDecimation(std::size_t series, Decimation method,
+                           float threshold) {
+  if (series >= m_numeric_data.size()) {
+    return;
+  }
+
+  m_numeric_data[series].style.decimation = {method, threshold};
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetDownsampling(std::size_t max_points) {
+  m_max_points = max_points;
+  for (auto &plot : m_numeric_data) {
+    plot.style.max_points = m_max_points;
+  }
+  for (auto &plot : m_categorical_data) {
+    plot.style.max_points = m_max_points;
+  }
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetDownsampling(std::size_t series, std::size_t max_points) {
+  if (series >= m_numeric_data.size()) {
+    return;
+  }
+
+  m_numeric_data[series].style.max_points = max_points;
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetStoragePrecision(StoragePrecision precision) {
+  m_storage_precision = precision;
+  for (auto &plot : m_numeric_data) {
+    ConvertStorage(plot, precision);
+  }
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::SetStoragePrecision(std::size_t series,
+                                 StoragePrecision precision) {
+  if (series >= m_numeric_data.size()) {
+    return;
+  }
+
+  ConvertStorage(m_numeric_data[series], precision);
+  Invalidate(Layer::DATA);
+}
+
+const Plot2D::DataStats &Plot2D::GetDataStats() const { return m_data_stats; }
+
+void Plot2D::SetNumThreads(std::size_t num_threads) {
+  if (num_threads == 0) {
+    m_thread_pool.reset();
+  } else {
+    m_thread_pool = std::make_shared<ThreadPool>(num_threads);
+  }
+}
+
 void Plot2D::SetLegend(const std::vector<std::string> &labels) {
+  Invalidate(Layer::LEGEND);
+
   if (labels.empty()) {
     m_legend_labels.clear();
     return;
@@ -256,6 +570,7 @@ void Plot2D::Clear() {
   m_y_set_range.reset();
   ClearMarkers();
   m_svg.Reset();
+  InvalidateAll();
 }
 
 void Plot2D::ClearMarkers() {
@@ -263,32 +578,100 @@ void Plot2D::ClearMarkers() {
   m_y_markers.clear();
   m_x_custom_markers.clear();
   m_y_custom_markers.clear();
+  Invalidate(Layer::FRAME);
+}
+
+void Plot2D::ClearData() {
+  m_numeric_data.clear();
+  InvalidateData();
+}
+
+void Plot2D::InvalidateData() {
+  Invalidate(Layer::DATA);
+  Invalidate(Layer::LEGEND);
+}
+
+void Plot2D::PlotNumeric(DataArray &&x_data, DataArray &&y_data,
+                         const Color &color, const float stroke_width,
+                         const std::string &dash_array) {
+  if (x_data.size() != y_data.size()) {
+    return;
+  }
+
+  const Style style = {color, stroke_width, dash_array, false,
+                       m_simplification, m_decimation, m_max_points};
+  AddNumericSeries(std::move(x_data), std::move(y_data), style);
+}
+
+void Plot2D::ScatterNumeric(DataArray &&x_data, DataArray &&y_data,
+                            const Color &color, const float radius) {
+  if (x_data.size() != y_data.size()) {
+    return;
+  }
+
+  const Style style = {color, radius, "", true, m_simplification,
+                       m_decimation, m_max_points};
+  AddNumericSeries(std::move(x_data), std::move(y_data), style);
 }
 
-void Plot2D::ClearData() { m_numeric_data.clear(); }
+void Plot2D::AddNumericSeries(DataArray &&x_data, DataArray &&y_data,
+                              const Style &style) {
+  if (m_hold == false) {
+    m_numeric_data.clear();
+  }
+
+  const auto x_range = reduction::FiniteRange(x_data);
+  const auto y_range = reduction::FiniteRange(y_data);
+  const bool x_sorted = reduction::IsSorted(x_data);
+  m_numeric_data.emplace_back(DataSeries{std::move(x_data), std::move(y_data),
+                                         style, x_range, y_range, x_sorted,
+                                         nullptr, nullptr});
+  ConvertStorage(m_numeric_data.back(), m_storage_precision);
+
+  m_data_type = DataType::NUMERIC;
+  m_categorical_data.clear();
+  InvalidateData();
+}
 
 void Plot2D::Build() {
-  m_svg.Reset();
   m_svg.SetSize(m_width, m_height);
+  m_rebuilt_layers.reset();
 
+  // The axes change with the data if their ranges are not set
+  const auto x_range = m_x_range;
+  const auto y_range = m_y_range;
   CalculateFrame();
+  if ((m_x_range != x_range) || (m_y_range != y_range)) {
+    Invalidate(Layer::FRAME);
+    Invalidate(Layer::DATA);
+  }
 
-  DrawBackground();
-  DrawTitle();
-  DrawFrame();
-  DrawLabels();
-  DrawData();
-  DrawLegend();
+  if (BeginLayer(Layer::BACKGROUND)) {
+    DrawBackground();
+  }
+  if (BeginLayer(Layer::TITLE)) {
+    DrawTitle();
+  }
+  if (BeginLayer(Layer::FRAME)) {
+    DrawFrame();
+  }
+  if (BeginLayer(Layer::LABELS)) {
+    DrawLabels();
+  }
+  if (BeginLayer(Layer::DATA)) {
+    DrawData();
+  }
+  if (BeginLayer(Layer::LEGEND)) {
+    DrawLegend();
+  }
 }
 
 void Plot2D::CalculateFrame() {
   // Frame rectangle
   m_frame_x = static_cast<float>(m_width) * FRAME_LEFT_MARGIN_REL;
   m_frame_y = static_cast<float>(m_height) * (FRAME_TOP_MARGIN_REL);
-  m_frame_w = static_cast<float>(m_width) *
-              (1.0f - FRAME_LEFT_MARGIN_REL - FRAME_RIGHT_MARGIN_REL);
-  m_frame_h = static_cast<float>(m_height) *
-              (1.0f - FRAME_TOP_MARGIN_REL - FRAME_BOTTOM_MARGIN_REL);
+  m_frame_w = FrameWidth();
+  m_frame_h = FrameHeight();
 
   switch (m_data_type) {
   case DataType::NUMERIC:
@@ -327,32 +710,31 @@ void Plot2D::CalculateFrame() {
 }
 
 void Plot2D::CalculateNumericFrame() {
-  // Ranges
-  Real min_x = std::numeric_limits<Real>::max();
-  Real max_x = std::numeric_limits<Real>::lowest();
-  Real min_y = std::numeric_limits<Real>::max();
-  Real max_y = std::numeric_limits<Real>::lowest();
-  for (auto &plot : m_numeric_data) {
-    const std::size_t size = plot.x.size();
-    for (std::size_t i = 0; i < size; ++i) {
-      const Real x = plot.x[i];
-      const Real y = plot.y[i];
-
-      if (!IsInfinity(x)) {
-        min_x = std::min(x, min_x);
-        max_x = std::max(x, max_x);
-      }
-      if (!IsInfinity(y)) {
-        min_y = std::min(y, min_y);
-        max_y = std::max(y, max_y);
-      }
+  // Ranges are combined from the ones cached in each series
+  m_x_data_range = reduction::EMPTY_RANGE;
+  m_y_data_range = reduction::EMPTY_RANGE;
+  for (const auto &plot : m_numeric_data) {
+    if (!plot.generator) {
+      m_x_data_range = reduction::Combine(m_x_data_range, plot.x_range);
+      m_y_data_range = reduction::Combine(m_y_data_range, plot.y_range);
+    } else if (plot.generator->domain.has_value()) {
+      m_x_data_range = reduction::Combine(m_x_data_range, plot.x_range);
     }
   }
-  m_x_data_range = {min_x, max_x};
-  m_y_data_range = {min_y, max_y};
 
   m_x_range =
       m_x_set_range.has_value() ? m_x_set_range.value() : m_x_data_range;
+
+  // Generated series are sampled for the x range, so they only extend the y
+  // range
+  for (auto &plot : m_numeric_data) {
+    if (!plot.generator) {
+      continue;
+    }
+    SampleGenerator(plot);
+    m_y_data_range = reduction::Combine(m_y_data_range, plot.y_range);
+  }
+
   m_y_range =
       m_y_set_range.has_value() ? m_y_set_range.value() : m_y_data_range;
 
@@ -363,25 +745,121 @@ void Plot2D::CalculateNumericFrame() {
       static_cast<float>(m_frame_h / (m_y_range.second - m_y_range.first)));
 }
 
-std::pair<float, float> Plot2D::TranslateToFrame(Real x, Real y) const {
-  float tx = static_cast<float>(m_zoom_x * (x - m_x_range.first));
-  float ty = static_cast<float>(m_frame_h - (m_zoom_y * (y - m_y_range.first)));
-  return {tx, ty};
+void Plot2D::SampleGenerator(DataSeries &plot) {
+  // Calls of the generator are batched to amortize the cost of a task
+  static constexpr std::size_t GENERATOR_CHUNK_SIZE = 64;
+
+  // Functions with a domain are only sampled in its visible part
+  Generator &generator = *plot.generator;
+  ranges::Interval<Real> x_range = m_x_range;
+  if (generator.domain.has_value()) {
+    x_range.first = std::max(x_range.first, generator.domain->first);
+    x_range.second = std::min(x_range.second, generator.domain->second);
+  }
+
+  if ((generator.x_range == x_range) && (generator.frame_w == m_frame_w) &&
+      (generator.frame_h == m_frame_h)) {
+    return;
+  }
+
+  generator.x_range = x_range;
+  generator.frame_w = m_frame_w;
+  generator.frame_h = m_frame_h;
+  generator.x.clear();
+  generator.y.clear();
+
+  const auto [x_min, x_max] = x_range;
+  if ((x_min < x_max) && std::isfinite(x_min) && std::isfinite(x_max)) {
+    if (generator.domain.has_value()) {
+      const auto width = static_cast<float>(
+          m_frame_w * (x_max - x_min) / (m_x_range.second - m_x_range.first));
+      std::tie(generator.x, generator.y) = sampling::SampleAdaptive(
+          generator.function, x_min, x_max, width, m_frame_h);
+    } else {
+      const std::size_t num_samples =
+          static_cast<std::size_t>(std::ceil(m_frame_w)) + 1;
+      generator.x.resize(num_samples);
+      generator.y.resize(num_samples);
+
+      const Real step = (x_max - x_min) / static_cast<Real>(num_samples - 1);
+      const std::size_t num_chunks =
+          (num_samples + GENERATOR_CHUNK_SIZE - 1) / GENERATOR_CHUNK_SIZE;
+      GetThreadPool().ParallelFor(num_chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * GENERATOR_CHUNK_SIZE;
+        const std::size_t end =
+            std::min(begin + GENERATOR_CHUNK_SIZE, num_samples);
+        for (std::size_t i = begin; i < end; ++i) {
+          generator.x[i] = (i == num_samples - 1)
+                               ? x_max
+                               : x_min + step * static_cast<Real>(i);
+          generator.y[i] = generator.function(generator.x[i]);
+        }
+      });
+    }
+  }
+
+  // The domain stays the x range of the series, so that it is sampled again
+  // when the figure is zoomed out
+  plot.x = DataArray(std::span<const Real>(generator.x));
+  plot.y = DataArray(std::span<const Real>(generator.y));
+  plot.x_range = generator.domain.has_value() ? generator.domain.value()
+                                              : reduction::FiniteRange(plot.x);
+  plot.y_range = reduction::FiniteRange(plot.y);
+  plot.x_sorted = true;
+  Invalidate(Layer::DATA);
+}
+
+void Plot2D::ConvertStorage(DataSeries &plot, StoragePrecision precision) {
+  bool converted = false;
+  switch (precision) {
+  case StoragePrecision::FLOAT32:
+    converted |= ConvertArray<float>(plot.x);
+    converted |= ConvertArray<float>(plot.y);
+    break;
+  case StoragePrecision::FLOAT64:
+    converted |= ConvertArray<double>(plot.x);
+    converted |= ConvertArray<double>(plot.y);
+    break;
+  default:
+    break;
+  }
+
+  // Rounding keeps the order of the values but may change their range
+  if (converted) {
+    plot.x_range = reduction::FiniteRange(plot.x);
+    plot.y_range = reduction::FiniteRange(plot.y);
+  }
+}
+
+transform::Affine Plot2D::FrameTransformX() const {
+  return {m_x_range.first, m_zoom_x, 0.0, m_frame_x};
+}
+
+transform::Affine Plot2D::FrameTransformY() const {
+  return {m_y_range.first, -m_zoom_y, m_frame_h, m_frame_y};
+}
+
+clipping::Rect Plot2D::FrameRect(float margin) const {
+  return {m_frame_x - margin, m_frame_y - margin,
+          m_frame_x + m_frame_w + margin, m_frame_y + m_frame_h + margin};
+}
+
+float Plot2D::FrameWidth() const {
+  return static_cast<float>(m_width) *
+         (1.0f - FRAME_LEFT_MARGIN_REL - FRAME_RIGHT_MARGIN_REL);
+}
+
+float Plot2D::FrameHeight() const {
+  return static_cast<float>(m_height) *
+         (1.0f - FRAME_TOP_MARGIN_REL - FRAME_BOTTOM_MARGIN_REL);
 }
 
 void Plot2D::CalculateCategoricalFrame() {
-  // Ranges
-  Real min_y = std::numeric_limits<Real>::max();
-  Real max_y = std::numeric_limits<Real>::lowest();
+  // Ranges are combined from the ones cached in each series
+  m_y_data_range = reduction::EMPTY_RANGE;
   for (const auto &data : m_categorical_data) {
-    for (const auto &y : data.y) {
-      if (!IsInfinity(y)) {
-        min_y = std::min(y, min_y);
-        max_y = std::max(y, max_y);
-      }
-    }
+    m_y_data_range = reduction::Combine(m_y_data_range, data.y_range);
   }
-  m_y_data_range = {min_y, max_y};
 
   m_y_range =
       m_y_set_range.has_value() ? m_y_set_range.value() : m_y_data_range;
@@ -401,6 +879,12 @@ void Plot2D::DrawBackground() { m_svg.DrawBackground(BACKGROUND_COLOR); }
 void Plot2D::DrawFrame() {
   components::Frame frame(m_frame_w, m_frame_h, m_grid_enable);
 
+  // Markers are placed relative to the frame
+  transform::Affine to_frame_x = FrameTransformX();
+  transform::Affine to_frame_y = FrameTransformY();
+  to_frame_x.offset = 0;
+  to_frame_y.offset = 0;
+
   // Y axis
   std::set<Real> left_markers;
   left_markers.insert(m_y_markers.begin(), m_y_markers.end());
@@ -411,8 +895,8 @@ void Plot2D::DrawFrame() {
       continue;
     }
 
-    const auto [_, y] = TranslateToFrame(0, marker);
-    frame.AddLeftMarker(y, fmt::format("{:.2f}", marker));
+    frame.AddLeftMarker(transform::Apply(to_frame_y, marker),
+                        fmt::format("{:.2f}", marker));
   }
 
   // X axis
@@ -426,8 +910,8 @@ void Plot2D::DrawFrame() {
         continue;
       }
 
-      const auto [x, _] = TranslateToFrame(marker, 0);
-      frame.AddBottomMarker(x, fmt::format("{:.2g}", marker));
+      frame.AddBottomMarker(transform::Apply(to_frame_x, marker),
+                            fmt::format("{:.2g}", marker));
     }
   } else if (m_data_type == DataType::CATEGORICAL) {
     const std::size_t num_labels = m_categorical_labels.size();
@@ -447,6 +931,14 @@ void Plot2D::DrawFrame() {
 }
 
 void Plot2D::DrawData() {
+  // Markers are defined before the data layer is opened, since drawing into
+  // <defs> closes the open elements of streaming documents
+  DefineScatterMarkers();
+
+  m_data_stats = {};
+  m_data_layer = m_svg.AddGroup();
+  svg::SetAttribute(m_data_layer, "clip-path", FRAME_RECT_CLIP_PATH_URL);
+
   switch (m_data_type) {
   case DataType::NUMERIC:
     DrawNumericData();
@@ -459,42 +951,203 @@ void Plot2D::DrawData() {
   }
 }
 
+ThreadPool &Plot2D::GetThreadPool() const {
+  return m_thread_pool ? *m_thread_pool : ThreadPool::Default();
+}
+
 void Plot2D::DrawNumericData() {
-  for (const auto &plot : m_numeric_data) {
+  const std::size_t num_plots = m_numeric_data.size();
+
+  // The paths of line series are generated in parallel and drawn in order
+  // afterwards, so the document is the same with any number of threads
+  std::vector<SeriesPath> series_paths(num_plots);
+  std::vector<std::size_t> line_plots;
+  for (std::size_t i = 0; i < num_plots; ++i) {
+    if (m_numeric_data[i].style.scatter == false) {
+      line_plots.push_back(i);
+    }
+  }
+
+  GetThreadPool().ParallelFor(line_plots.size(), [&](std::size_t i) {
+    const std::size_t index = line_plots[i];
+    series_paths[index] = FormatNumericPath(m_numeric_data[index]);
+  });
+
+  for (std::size_t i = 0; i < num_plots; ++i) {
+    const DataSeries &plot = m_numeric_data[i];
     if (plot.style.scatter == false) {
-      DrawNumericPath(plot);
+      DrawNumericPath(plot, series_paths[i]);
     } else {
       DrawNumericScatter(plot);
     }
   }
 }
 
-void Plot2D::DrawNumericPath(const DataSeries &plot) {
-  svg::Path path;
-  path.stroke_color = plot.style.color;
-  path.stroke_width = plot.style.stroke;
+Plot2D::FramePath Plot2D::TranslateNumericPath(const DataSeries &plot) const {
+  const std::size_t max_points = plot.style.max_points;
+  const bool must_clip = plot.style.dash_array.empty();
+
+  // Downsampling spends its budget in the visible window only, and clipped
+  // lines only need the points in it. A point is kept at each side, so that
+  // the line reaches the border of the frame. The window of sorted series is
+  // found with a binary search.
+  std::size_t first = 0;
+  std::size_t last = plot.x.size();
+  if (plot.x_sorted && (must_clip || (max_points > 0))) {
+    std::tie(first, last) = reduction::SortedWindow(plot.x, m_x_range);
+    first = (first > 0) ? first - 1 : first;
+    last = (last < plot.x.size()) ? last + 1 : last;
+  } else if (max_points > 0) {
+    const auto is_visible = [this](auto x) {
+      const Real value = static_cast<Real>(x);
+      return (value >= m_x_range.first) && (value <= m_x_range.second);
+    };
+    plot.x.Visit([&](auto data_x) {
+      const auto first_visible =
+          std::find_if(data_x.begin(), data_x.end(), is_visible);
+      if (first_visible != data_x.end()) {
+        const auto last_visible =
+            std::find_if(data_x.rbegin(), data_x.rend(), is_visible);
+        first = static_cast<std::size_t>(first_visible - data_x.begin());
+        last = static_cast<std::size_t>(data_x.rend() - last_visible);
+        first = (first > 0) ? first - 1 : first;
+        last = (last < data_x.size()) ? last + 1 : last;
+      }
+    });
+  }
 
-  const std::vector<Real> &data_x = plot.x;
-  const std::vector<Real> &data_y = plot.y;
-  const std::size_t size = data_x.size();
+  const std::size_t size = last - first;
+  FramePath frame_path;
+  frame_path.stats.culled_vertices = plot.x.size() - size;
+  std::vector<float> &frame_x = frame_path.x;
+  std::vector<float> &frame_y = frame_path.y;
+  frame_x.resize(size);
+  frame_y.resize(size);
+  transform::Apply(FrameTransformX(), plot.x, first, size, frame_x.data());
+  transform::Apply(FrameTransformY(), plot.y, first, size, frame_y.data());
+
+  // Points with infinite or NaN coordinates split the line into separate
+  // polylines, so that only finite points reach the reduction algorithms.
+  // Solid lines are also clipped to the frame, with a margin that keeps the
+  // caps and joins at the clipped ends outside of it. Dashed lines are not
+  // clipped, since that would shift their dash pattern.
+  const auto is_finite = [&](std::size_t i) {
+    return std::isfinite(frame_x[i]) && std::isfinite(frame_y[i]);
+  };
+  const clipping::Rect clip_rect = FrameRect(2.0f * plot.style.stroke + 1.0f);
+  std::vector<float> clipped_x;
+  std::vector<float> clipped_y;
+  std::vector<std::size_t> polyline_sizes;
+  std::size_t num_points = 0;
+  std::size_t start = 0;
+  while (start < size) {
+    while ((start < size) && !is_finite(start)) {
+      ++start;
+    }
+    std::size_t end = start;
+    while ((end < size) && is_finite(end)) {
+      ++end;
+    }
 
-  for (std::size_t i = 0; i < size; ++i) {
-    if (IsInfinity(data_y[i])) {
-      continue;
+    if (must_clip) {
+      frame_path.stats.culled_vertices += clipping::ClipPolyline(
+          &frame_x[start], &frame_y[start], end - start, clip_rect, clipped_x,
+          clipped_y, polyline_sizes);
+    } else if (end > start) {
+      std::copy_n(&frame_x[start], end - start, &frame_x[num_points]);
+      std::copy_n(&frame_y[start], end - start, &frame_y[num_points]);
+      polyline_sizes.push_back(end - start);
+      num_points += end - start;
     }
+    start = end;
+  }
+  if (must_clip) {
+    frame_x.swap(clipped_x);
+    frame_y.swap(clipped_y);
+    num_points = frame_x.size();
+  }
 
-    const bool must_join_points = (i > 0) && !IsInfinity(data_y[i - 1]);
-    const auto path_cmd = must_join_points ? svg::PathCommand::Id::LINE
-                                           : svg::PathCommand::Id::MOVE;
-    const auto [tx, ty] = TranslateToFrame(data_x[i], data_y[i]);
-    path.Add({path_cmd, {tx + m_frame_x, ty + m_frame_y}});
+  const DecimationSettings &decimation = plot.style.decimation;
+  const bool must_decimate =
+      (decimation.method == Decimation::M4) &&
+      (static_cast<float>(num_points) > decimation.threshold * m_frame_w);
+  const float column_min = std::floor(m_frame_x) - 1.0f;
+  const float column_max = m_frame_x + m_frame_w + 1.0f;
+
+  // The budget of downsampling is shared between polylines
+  const std::vector<std::size_t> budgets =
+      (max_points > 0) ? ShareBudget(polyline_sizes, max_points)
+                       : std::vector<std::size_t>();
+
+  // The kept points of each polyline are moved to the front of the arrays
+  std::size_t num_kept = 0;
+  start = 0;
+  for (std::size_t i = 0; i < polyline_sizes.size(); ++i) {
+    const std::size_t end = start + polyline_sizes[i];
+    std::size_t kept = polyline_sizes[i];
+    if (max_points > 0) {
+      kept = (budgets[i] > 0)
+                 ? sampling::DownsampleLTTB(&frame_x[start], &frame_y[start],
+                                            kept, budgets[i])
+                 : 0;
+      frame_path.stats.downsampled_vertices += end - start - kept;
+    }
+    if (must_decimate) {
+      const std::size_t size_before = kept;
+      kept = sampling::DecimateM4(&frame_x[start], &frame_y[start], kept,
+                                  column_min, column_max);
+      frame_path.stats.decimated_vertices += size_before - kept;
+    }
+    const std::size_t size_before = kept;
+    kept = SimplifyPolyline(&frame_x[start], &frame_y[start], kept,
+                            plot.style);
+    frame_path.stats.removed_vertices += size_before - kept;
+
+    if (kept > 0) {
+      std::copy_n(&frame_x[start], kept, &frame_x[num_kept]);
+      std::copy_n(&frame_y[start], kept, &frame_y[num_kept]);
+      frame_path.polyline_sizes.push_back(kept);
+      num_kept += kept;
+    }
+    start = end;
+  }
+
+  frame_x.resize(num_kept);
+  frame_y.resize(num_kept);
+  return frame_path;
+}
+
+Plot2D::SeriesPath Plot2D::FormatNumericPath(const DataSeries &plot) const {
+  const FramePath frame_path = TranslateNumericPath(plot);
+
+  svg::Path path;
+  const std::size_t size = frame_path.x.size();
+  path.Reserve(size, 2 * size);
+  std::size_t start = 0;
+  for (const std::size_t polyline_size : frame_path.polyline_sizes) {
+    path.AddPolyline(&frame_path.x[start], &frame_path.y[start],
+                     polyline_size);
+    start += polyline_size;
   }
 
-  auto path_node = m_svg.DrawPath(path);
+  SeriesPath series_path;
+  path.AppendData(series_path.data, m_svg.GetPrecision());
+  series_path.stats = frame_path.stats;
+  return series_path;
+}
+
+void Plot2D::DrawNumericPath(const DataSeries &plot,
+                             const SeriesPath &series_path) {
+  svg::Path path;
+  path.stroke_color = plot.style.color;
+  path.stroke_width = plot.style.stroke;
+
+  m_data_stats.removed_vertices += series_path.stats.removed_vertices;
+  m_data_stats.decimated_vertices += series_path.stats.decimated_vertices;
+  m_data_stats.downsampled_vertices += series_path.stats.downsampled_vertices;
+  m_data_stats.culled_vertices += series_path.stats.culled_vertices;
 
-  std::stringstream clip_path_url_ss;
-  clip_path_url_ss << "url(#" << FRAME_RECT_CLIP_PATH_ID << ")";
-  svg::SetAttribute(path_node, "clip-path", clip_path_url_ss.str());
+  auto path_node = m_svg.DrawPath(path, series_path.data, m_data_layer);
 
   svg::SetAttribute(path_node, "stroke-linecap", "round");
   if (!plot.style.dash_array.empty()) {
@@ -505,43 +1158,98 @@ void Plot2D::DrawNumericPath(const DataSeries &plot) {
   // svg::SetAttribute(path_node, "stroke-linejoin", "bevel");
 }
 
+std::size_t Plot2D::SimplifyPolyline(float *x, float *y, std::size_t size,
+                                     const Style &style) {
+  const float tolerance = style.simplification.tolerance;
+  std::size_t kept = size;
+  switch (style.simplification.method) {
+  case Simplification::DOUGLAS_PEUCKER:
+    kept = sampling::SimplifyDouglasPeucker(x, y, size, tolerance);
+    break;
+  case Simplification::VISVALINGAM:
+    kept = sampling::SimplifyVisvalingam(x, y, size, tolerance);
+    break;
+  default:
+    break;
+  }
+
+  return kept;
+}
+
 void Plot2D::DrawNumericScatter(const DataSeries &plot) {
-  const std::vector<Real> &data_x = plot.x;
-  const std::vector<Real> &data_y = plot.y;
-  const std::size_t size = data_x.size();
+  // Only the markers of sorted series that can reach the frame are translated
+  std::size_t first = 0;
+  std::size_t last = plot.x.size();
+  if (plot.x_sorted) {
+    const Real margin = plot.style.stroke / m_zoom_x;
+    std::tie(first, last) = reduction::SortedWindow(
+        plot.x, {m_x_range.first - margin, m_x_range.second + margin});
+  }
+  m_data_stats.culled_vertices += plot.x.size() - (last - first);
 
+  const std::size_t size = last - first;
+  std::vector<float> frame_x(size);
+  std::vector<float> frame_y(size);
+  transform::Apply(FrameTransformX(), plot.x, first, size, frame_x.data());
+  transform::Apply(FrameTransformY(), plot.y, first, size, frame_y.data());
+
+  // Markers of infinite values and markers outside the frame are not drawn
+  const clipping::Rect marker_rect = FrameRect(plot.style.stroke);
+  std::size_t num_visible = 0;
   for (std::size_t i = 0; i < size; ++i) {
-    if (IsInfinity(data_y[i])) {
+    if (IsInfinity(frame_y[i])) {
       continue;
     }
-    const auto [tx, ty] = TranslateToFrame(data_x[i], data_y[i]);
-
-    auto circle_node = m_svg.DrawCircle(
-        {tx + m_frame_x, ty + m_frame_y, plot.style.stroke, plot.style.color});
-
-    std::stringstream clip_path_url_ss;
-    clip_path_url_ss << "url(#" << FRAME_RECT_CLIP_PATH_ID << ")";
-    svg::SetAttribute(circle_node, "clip-path", clip_path_url_ss.str());
+    if (!marker_rect.Contains(frame_x[i], frame_y[i])) {
+      ++m_data_stats.culled_vertices;
+      continue;
+    }
+    frame_x[num_visible] = frame_x[i];
+    frame_y[num_visible] = frame_y[i];
+    ++num_visible;
   }
+  frame_x.resize(num_visible);
+  frame_y.resize(num_visible);
+
+  DrawScatterMarkers(frame_x, frame_y, plot.style);
 }
 
 void Plot2D::DrawCategoricalData() {
-  for (const auto &plot : m_categorical_data) {
+  const std::size_t num_plots = m_categorical_data.size();
+
+  std::vector<std::string> path_data(num_plots);
+  std::vector<std::size_t> line_plots;
+  for (std::size_t i = 0; i < num_plots; ++i) {
+    if (m_categorical_data[i].style.scatter == false) {
+      line_plots.push_back(i);
+    }
+  }
+
+  GetThreadPool().ParallelFor(line_plots.size(), [&](std::size_t i) {
+    const std::size_t index = line_plots[i];
+    path_data[index] = FormatCategoricalPath(m_categorical_data[index]);
+  });
+
+  for (std::size_t i = 0; i < num_plots; ++i) {
+    const CategoricalDataSeries &plot = m_categorical_data[i];
     if (plot.style.scatter == false) {
-      DrawCategoricalPath(plot);
+      DrawCategoricalPath(plot, path_data[i]);
     } else {
       DrawCategoricalScatter(plot);
     }
   }
 }
 
-void Plot2D::DrawCategoricalPath(const CategoricalDataSeries &plot) {
+std::string
+Plot2D::FormatCategoricalPath(const CategoricalDataSeries &plot) const {
   svg::Path path;
-  path.stroke_color = plot.style.color;
-  path.stroke_width = plot.style.stroke;
-
   const std::vector<Real> &data_y = plot.y;
   const std::size_t size = data_y.size();
+  path.Reserve(size, 2 * size);
+
+  std::vector<float> frame_y(size);
+  transform::Apply(FrameTransformY(), std::span<const Real>(data_y),
+                   frame_y.data());
 
   for (std::size_t i = 0; i < size; ++i) {
     if (IsInfinity(data_y[i])) {
@@ -549,19 +1257,27 @@ void Plot2D::DrawCategoricalPath(const CategoricalDataSeries &plot) {
     }
 
     const bool must_join_points = (i > 0) && !IsInfinity(data_y[i - 1]);
-    const auto path_cmd = must_join_points ? svg::PathCommand::Id::LINE
-                                           : svg::PathCommand::Id::MOVE;
-    const auto [_, ty] = TranslateToFrame(0, data_y[i]);
     const float tx =
         static_cast<float>(i) * (m_frame_w / static_cast<float>(size - 1));
-    path.Add({path_cmd, {tx + m_frame_x, ty + m_frame_y}});
+    if (must_join_points) {
+      path.LineTo(tx + m_frame_x, frame_y[i]);
+    } else {
+      path.MoveTo(tx + m_frame_x, frame_y[i]);
+    }
   }
 
-  auto path_node = m_svg.DrawPath(path);
+  std::string path_data;
+  path.AppendData(path_data, m_svg.GetPrecision());
+  return path_data;
+}
+
+void Plot2D::DrawCategoricalPath(const CategoricalDataSeries &plot,
+                                 const std::string &path_data) {
+  svg::Path path;
+  path.stroke_color = plot.style.color;
+  path.stroke_width = plot.style.stroke;
 
-  std::stringstream clip_path_url_ss;
-  clip_path_url_ss << "url(#" << FRAME_RECT_CLIP_PATH_ID << ")";
-  svg::SetAttribute(path_node, "clip-path", clip_path_url_ss.str());
+  auto path_node = m_svg.DrawPath(path, path_data, m_data_layer);
 
   svg::SetAttribute(path_node, "stroke-linecap", "round");
   if (!plot.style.dash_array.empty()) {
@@ -573,26 +1289,153 @@ void Plot2D::DrawCategoricalScatter(const CategoricalDataSeries &plot) {
   const std::vector<Real> &data_y = plot.y;
   const std::size_t size = data_y.size();
 
+  std::vector<float> frame_x(size);
+  std::vector<float> frame_y(size);
+  transform::Apply(FrameTransformY(), std::span<const Real>(data_y),
+                   frame_y.data());
+
+  // Markers of infinite values and markers outside the frame are not drawn
+  const clipping::Rect marker_rect = FrameRect(plot.style.stroke);
+  std::size_t num_visible = 0;
   for (std::size_t i = 0; i < size; ++i) {
     if (IsInfinity(data_y[i])) {
       continue;
     }
 
-    const auto [_, ty] = TranslateToFrame(0, data_y[i]);
     const float tx =
         static_cast<float>(i) * (m_frame_w / static_cast<float>(size - 1));
+    if (!marker_rect.Contains(tx + m_frame_x, frame_y[i])) {
+      ++m_data_stats.culled_vertices;
+      continue;
+    }
+    frame_x[num_visible] = tx + m_frame_x;
+    frame_y[num_visible] = frame_y[i];
+    ++num_visible;
+  }
+  frame_x.resize(num_visible);
+  frame_y.resize(num_visible);
 
-    svg::Circle circle{
-        .cx = tx + m_frame_x,
-        .cy = ty + m_frame_y,
-        .r = plot.style.stroke,
-        .fill_color = plot.style.color,
-    };
-    auto circle_node = m_svg.DrawCircle(circle);
+  DrawScatterMarkers(frame_x, frame_y, plot.style);
+}
 
-    std::stringstream clip_path_url_ss;
-    clip_path_url_ss << "url(#" << FRAME_RECT_CLIP_PATH_ID << ")";
-    svg::SetAttribute(circle_node, "clip-path", clip_path_url_ss.str());
+std::string Plot2D::ScatterMarkerId(const Style &style) {
+  // The id is made of the properties of the marker, so that markers with the
+  // same id are the same also when documents are merged into a GroupFigure
+  return fmt::format("marker-{:02x}{:02x}{:02x}-{:g}", style.color.r,
+                     style.color.g, style.color.b, style.stroke);
+}
+
+void Plot2D::DefineScatterMarkers() {
+  if (m_scatter_mode != ScatterMode::SYMBOLS) {
+    return;
+  }
+
+  // Series with the same marker share its definition
+  std::set<std::string> defined_ids;
+  const auto define_marker = [&](const Style &style) {
+    if (!style.scatter) {
+      return;
+    }
+    std::string id = ScatterMarkerId(style);
+    if (defined_ids.contains(id)) {
+      return;
+    }
+    svg::Circle marker{.cx = 0, .cy = 0, .r = style.stroke,
+                       .fill_color = style.color};
+    m_svg.DrawCircle(marker, m_svg.Defs(), id);
+    defined_ids.insert(std::move(id));
+  };
+
+  switch (m_data_type) {
+  case DataType::NUMERIC:
+    for (const auto &plot : m_numeric_data) {
+      define_marker(plot.style);
+    }
+    break;
+  case DataType::CATEGORICAL:
+    for (const auto &plot : m_categorical_data) {
+      define_marker(plot.style);
+    }
+    break;
+  }
+}
+
+void Plot2D::DrawScatterMarkers(std::vector<float> &x, std::vector<float> &y,
+                                const Style &style) {
+  if ((m_overdraw_subpixels > 0) && (m_scatter_mode != ScatterMode::DENSITY)) {
+    const clipping::Rect rect = FrameRect(style.stroke);
+    const std::size_t kept =
+        sampling::RemoveOverdrawn(x.data(), y.data(), x.size(), rect.x0,
+                                  rect.y0, rect.x1, rect.y1,
+                                  m_overdraw_subpixels);
+    m_data_stats.overdrawn_markers += x.size() - kept;
+    x.resize(kept);
+    y.resize(kept);
+  }
+
+  const std::size_t size = x.size();
+  auto group_node = m_svg.AddGroup(m_data_layer);
+
+  switch (m_scatter_mode) {
+  case ScatterMode::CIRCLES: {
+    svg::Circle circle{.cx = 0, .cy = 0, .r = style.stroke,
+                       .fill_color = style.color};
+    for (std::size_t i = 0; i < size; ++i) {
+      circle.cx = x[i];
+      circle.cy = y[i];
+      m_svg.DrawCircle(circle, group_node);
+    }
+    break;
+  }
+
+  case ScatterMode::SYMBOLS: {
+    svg::Use use{.href = fmt::format("#{}", ScatterMarkerId(style)),
+                 .x = 0,
+                 .y = 0};
+    for (std::size_t i = 0; i < size; ++i) {
+      use.x = x[i];
+      use.y = y[i];
+      m_svg.DrawUse(use, group_node);
+    }
+    break;
+  }
+
+  case ScatterMode::PATH: {
+    // A zero-length segment with round caps is drawn as a filled circle with
+    // a diameter equal to the stroke width
+    svg::Path path;
+    path.stroke_color = style.color;
+    path.stroke_width = 2.0f * style.stroke;
+    path.Reserve(2 * size, 3 * size);
+    for (std::size_t i = 0; i < size; ++i) {
+      path.MoveTo(x[i], y[i]);
+      path.Add(svg::PathCommand::Id::HORIZONTAL_R, {0.0f});
+    }
+
+    auto path_node = m_svg.DrawPath(path, group_node);
+    svg::SetAttribute(path_node, "stroke-linecap", "round");
+    break;
+  }
+
+  case ScatterMode::DENSITY: {
+    // One cell per px of the frame
+    const auto width = static_cast<std::size_t>(std::ceil(m_frame_w));
+    const auto height = static_cast<std::size_t>(std::ceil(m_frame_h));
+    const density::Grid grid =
+        density::Accumulate(x.data(), y.data(), size, m_frame_x, m_frame_y,
+                            width, height, GetThreadPool());
+    const std::vector<std::uint8_t> rgba =
+        density::Colorize(grid, color_tables::VIRIDIS);
+
+    svg::Image image{.href = png::DataUri(png::Encode(rgba.data(), width,
+                                                      height)),
+                     .x = m_frame_x,
+                     .y = m_frame_y,
+                     .width = static_cast<float>(width),
+                     .height = static_cast<float>(height)};
+    m_svg.DrawImage(image, group_node);
+    break;
+  }
   }
 }
 
@@ -635,10 +1478,9 @@ void Plot2D::DrawLabels() {
         svg::Text{m_y_label, 0, 0, m_axis_font_size, components::TEXT_FONT});
     svg::SetAttribute(node_ptr, "text-anchor", "middle");
 
-    std::stringstream trans_ss;
-    trans_ss << "translate(" << std::to_string(x) << ", " << std::to_string(y)
-             << ") " << "rotate(-90)";
-    svg::SetAttribute(node_ptr, "transform", trans_ss.str());
+    const std::string transform = "translate(" + m_svg.FormatNumber(x) + ", " +
+                                  m_svg.FormatNumber(y) + ") rotate(-90)";
+    svg::SetAttribute(node_ptr, "transform", transform);
   }
 }
 
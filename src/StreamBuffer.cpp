@@ -0,0 +1,140 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StreamBuffer.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+#include "utility.hpp"
+
+namespace plotcpp {
+
+StreamBuffer::StreamBuffer(std::size_t capacity)
+    : m_capacity(capacity), m_x(2 * capacity), m_y(2 * capacity) {}
+
+void StreamBuffer::Append(Real x, Real y) {
+  if (m_capacity == 0) {
+    return;
+  }
+
+  // Pairs are not in order if they contain NaN
+  const auto is_descent = [](Real previous, Real next) {
+    return !(next >= previous);
+  };
+  if ((m_capacity > 1) && (m_size > 0) &&
+      is_descent(m_x[m_start + m_size - 1], x)) {
+    ++m_num_x_descents;
+  }
+
+  std::size_t position;
+  if (m_size < m_capacity) {
+    position = m_size;
+    ++m_size;
+  } else {
+    if ((m_capacity > 1) && is_descent(m_x[m_start], m_x[m_start + 1])) {
+      --m_num_x_descents;
+    }
+    position = m_start;
+    m_start = (m_start + 1) % m_capacity;
+  }
+
+  m_x[position] = m_x[position + m_capacity] = x;
+  m_y[position] = m_y[position + m_capacity] = y;
+
+  const std::size_t sequence = m_num_appended++;
+  m_x_range.Push(sequence, x);
+  m_y_range.Push(sequence, y);
+  if (m_num_appended > m_capacity) {
+    const std::size_t first_sequence = m_num_appended - m_capacity;
+    m_x_range.Evict(first_sequence);
+    m_y_range.Evict(first_sequence);
+  }
+}
+
+void StreamBuffer::Append(std::span<const Real> x_data,
+                          std::span<const Real> y_data) {
+  if (x_data.size() != y_data.size()) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < x_data.size(); ++i) {
+    Append(x_data[i], y_data[i]);
+  }
+}
+
+std::size_t StreamBuffer::Capacity() const { return m_capacity; }
+
+std::size_t StreamBuffer::Size() const { return m_size; }
+
+bool StreamBuffer::IsXSorted() const {
+  return (m_num_x_descents == 0) && ((m_size == 0) || !std::isnan(X()[0]));
+}
+
+std::span<const Real> StreamBuffer::X() const {
+  return std::span<const Real>(m_x).subspan(m_start, m_size);
+}
+
+std::span<const Real> StreamBuffer::Y() const {
+  return std::span<const Real>(m_y).subspan(m_start, m_size);
+}
+
+ranges::Interval<Real> StreamBuffer::XRange() const {
+  return m_x_range.Range();
+}
+
+ranges::Interval<Real> StreamBuffer::YRange() const {
+  return m_y_range.Range();
+}
+
+void StreamBuffer::SlidingRange::Push(std::size_t sequence, Real value) {
+  if (!std::isfinite(value)) {
+    return;
+  }
+
+  while (!m_min.empty() && (m_min.back().second >= value)) {
+    m_min.pop_back();
+  }
+  m_min.emplace_back(sequence, value);
+
+  while (!m_max.empty() && (m_max.back().second <= value)) {
+    m_max.pop_back();
+  }
+  m_max.emplace_back(sequence, value);
+}
+
+void StreamBuffer::SlidingRange::Evict(std::size_t first_sequence) {
+  while (!m_min.empty() && (m_min.front().first < first_sequence)) {
+    m_min.pop_front();
+  }
+  while (!m_max.empty() && (m_max.front().first < first_sequence)) {
+    m_max.pop_front();
+  }
+}
+
+ranges::Interval<Real> StreamBuffer::SlidingRange::Range() const {
+  if (m_min.empty()) {
+    return {std::numeric_limits<Real>::max(),
+            std::numeric_limits<Real>::lowest()};
+  }
+  return {m_min.front().second, m_max.front().second};
+}
+
+} // namespace plotcpp
@@ -0,0 +1,149 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace plotcpp {
+
+ThreadPool::ThreadPool(std::size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // The calling thread of each loop is one of the threads that run it
+  for (std::size_t i = 1; i < num_threads; ++i) {
+    m_threads.emplace_back([this]() { Work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+ThreadPool &ThreadPool::Default() {
+  static ThreadPool pool;
+  return pool;
+}
+
+std::size_t ThreadPool::NumThreads() const { return m_threads.size() + 1; }
+
+void ThreadPool::ParallelFor(std::size_t count,
+                             const std::function<void(std::size_t)> &function) {
+  if ((count <= 1) || m_threads.empty()) {
+    for (std::size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  const std::size_t num_helpers = std::min(m_threads.size(), count - 1);
+
+  // The state of the loop is shared with the helpers, since they may only
+  // start after the loop returns. The function is only called for claimed
+  // iterations, and the loop returns once all of them are completed.
+  struct Loop {
+    const std::function<void(std::size_t)> *function;
+    std::size_t count;
+    std::atomic<std::size_t> next = 0;
+    std::atomic<std::size_t> completed = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  auto loop = std::make_shared<Loop>();
+  loop->function = &function;
+  loop->count = count;
+
+  const auto run = [](Loop &loop) {
+    std::size_t i;
+    while ((i = loop.next++) < loop.count) {
+      // Iterations left after an exception are skipped
+      if (!loop.failed) {
+        try {
+          (*loop.function)(i);
+        } catch (...) {
+          std::lock_guard lock(loop.mutex);
+          if (!loop.error) {
+            loop.error = std::current_exception();
+          }
+          loop.failed = true;
+        }
+      }
+
+      if (++loop.completed == loop.count) {
+        std::lock_guard lock(loop.mutex);
+        loop.done.notify_all();
+      }
+    }
+  };
+
+  {
+    std::lock_guard lock(m_mutex);
+    for (std::size_t i = 0; i < num_helpers; ++i) {
+      m_tasks.emplace_back([loop, run]() { run(*loop); });
+    }
+  }
+  m_condition.notify_all();
+
+  // The calling thread runs iterations too, so the loop completes even if no
+  // helper starts, as in loops run from the threads of the pool
+  run(*loop);
+
+  std::unique_lock lock(loop->mutex);
+  loop->done.wait(lock, [&]() { return loop->completed == count; });
+  if (loop->error) {
+    std::rethrow_exception(loop->error);
+  }
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+      if (m_tasks.empty()) {
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    task();
+  }
+}
+
+} // namespace plotcpp
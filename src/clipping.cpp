@@ -0,0 +1,143 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "clipping.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace plotcpp {
+namespace clipping {
+
+/**
+ * @brief Clip the parameter interval [t0, t1] of a segment against one side
+ * of the rectangle, given as p * t <= q.
+ *
+ * @return False if the segment is outside
+ */
+static bool ClipSide(float p, float q, float &t0, float &t1) {
+  if (p == 0.0f) {
+    // Parallel to the side. False for NaN.
+    return q >= 0.0f;
+  }
+
+  const float t = q / p;
+  if (p < 0.0f) {
+    if (t > t1) {
+      return false;
+    }
+    if (t > t0) {
+      t0 = t;
+    }
+  } else {
+    if (t < t0) {
+      return false;
+    }
+    if (t < t1) {
+      t1 = t;
+    }
+  }
+  return true;
+}
+
+/** Liang-Barsky clipping of the segment (x0, y0) - (x1, y1) */
+static bool ClipSegment(float x0, float y0, float x1, float y1,
+                        const Rect &rect, float &t0, float &t1) {
+  const float dx = x1 - x0;
+  const float dy = y1 - y0;
+  if (std::isnan(dx) || std::isnan(dy)) {
+    return false;
+  }
+
+  t0 = 0.0f;
+  t1 = 1.0f;
+  return ClipSide(-dx, x0 - rect.x0, t0, t1) &&
+         ClipSide(dx, rect.x1 - x0, t0, t1) &&
+         ClipSide(-dy, y0 - rect.y0, t0, t1) &&
+         ClipSide(dy, rect.y1 - y0, t0, t1);
+}
+
+std::size_t ClipPolyline(const float *x, const float *y, std::size_t size,
+                         const Rect &rect, std::vector<float> &out_x,
+                         std::vector<float> &out_y,
+                         std::vector<std::size_t> &piece_sizes) {
+  std::size_t num_outside = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!rect.Contains(x[i], y[i])) {
+      ++num_outside;
+    }
+  }
+
+  // Most polylines are either completely visible or hidden
+  if (num_outside == 0) {
+    out_x.insert(out_x.end(), x, x + size);
+    out_y.insert(out_y.end(), y, y + size);
+    piece_sizes.push_back(size);
+    return 0;
+  }
+  if (size == 1) {
+    return num_outside;
+  }
+
+  // Number of points of the piece that ends at the start of the current
+  // segment, or 0 if there is none
+  std::size_t piece_size = 0;
+  for (std::size_t i = 0; i + 1 < size; ++i) {
+    float t0, t1;
+    if (!ClipSegment(x[i], y[i], x[i + 1], y[i + 1], rect, t0, t1)) {
+      if (piece_size > 0) {
+        piece_sizes.push_back(piece_size);
+        piece_size = 0;
+      }
+      continue;
+    }
+
+    const float dx = x[i + 1] - x[i];
+    const float dy = y[i + 1] - y[i];
+    if (piece_size == 0) {
+      if (t0 > 0.0f) {
+        out_x.push_back(x[i] + t0 * dx);
+        out_y.push_back(y[i] + t0 * dy);
+      } else {
+        out_x.push_back(x[i]);
+        out_y.push_back(y[i]);
+      }
+      piece_size = 1;
+    }
+
+    if (t1 < 1.0f) {
+      out_x.push_back(x[i] + t1 * dx);
+      out_y.push_back(y[i] + t1 * dy);
+      piece_sizes.push_back(piece_size + 1);
+      piece_size = 0;
+    } else {
+      out_x.push_back(x[i + 1]);
+      out_y.push_back(y[i + 1]);
+      ++piece_size;
+    }
+  }
+  if (piece_size > 0) {
+    piece_sizes.push_back(piece_size);
+  }
+
+  return num_outside;
+}
+
+} // namespace clipping
+} // namespace plotcpp
@@ -72,8 +72,7 @@ void Frame::DrawFullFrame(svg::Document *document, float x, float y) const {
       .height = m_height,
       .stroke_color = STROKE_COLOR,
   };
-  auto frame_node = document->DrawRect(frame_rect);
-  svg::SetAttribute(frame_node, "fill", "none");
+  document->DrawRect(frame_rect);
 
   auto defs_node = document->Defs();
   auto clip_path_node = svg::AppendNode(defs_node, "clipPath");
@@ -95,8 +94,7 @@ void Frame::DrawAxesOnly(svg::Document *document, float x, float y) const {
       .fill_opacity = 0.0f,
       .fill_transparent = true,
   };
-  auto frame_node = document->DrawRect(frame_rect);
-  svg::SetAttribute(frame_node, "fill", "none");
+  document->DrawRect(frame_rect);
 
   document->DrawLine({x, y, x, y + m_height, STROKE_COLOR});
   document->DrawLine(
@@ -72,12 +72,15 @@ void Legend::Draw(svg::Document *document, float x, float y, float margin,
                         .y = y,
                         .width = box_w,
                         .height = box_h,
-                        .stroke_color = STROKE_COLOR};
+                        .stroke_color = STROKE_COLOR,
+                        .fill_color = BOX_COLOR,
+                        .fill_opacity = BOX_OPACITY,
+                        .fill_transparent = false};
   auto box_rect_node = document->DrawRect(box_rect);
-  svg::SetAttribute(box_rect_node, "fill", svg::ColorToString(BOX_COLOR));
-  svg::SetAttribute(box_rect_node, "fill-opacity", std::to_string(BOX_OPACITY));
-  svg::SetAttribute(box_rect_node, "rx", std::to_string(BOX_RADIUS), "px");
-  svg::SetAttribute(box_rect_node, "ry", std::to_string(BOX_RADIUS), "px");
+  svg::SetAttribute(box_rect_node, "rx", document->FormatNumber(BOX_RADIUS),
+                    "px");
+  svg::SetAttribute(box_rect_node, "ry", document->FormatNumber(BOX_RADIUS),
+                    "px");
 
   for (std::size_t i = 0; i < num_labels; ++i) {
     const LegendEntry label = m_legend_labels[i];
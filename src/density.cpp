@@ -0,0 +1,111 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "density.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+#include "utility.hpp"
+
+namespace plotcpp {
+namespace density {
+
+// Chunks smaller than this are not worth a grid of their own
+static constexpr std::size_t MIN_CHUNK_SIZE = 1 << 16;
+
+Grid Accumulate(const float *x, const float *y, std::size_t size, float x0,
+                float y0, std::size_t width, std::size_t height,
+                ThreadPool &pool) {
+  const std::size_t num_chunks = std::clamp<std::size_t>(
+      size / MIN_CHUNK_SIZE, 1, pool.NumThreads());
+  const std::size_t chunk_size = (size + num_chunks - 1) / num_chunks;
+  const auto fwidth = static_cast<float>(width);
+  const auto fheight = static_cast<float>(height);
+
+  std::vector<std::vector<std::uint32_t>> chunk_counts(num_chunks);
+  pool.ParallelFor(num_chunks, [&](std::size_t chunk) {
+    std::vector<std::uint32_t> &counts = chunk_counts[chunk];
+    counts.assign(width * height, 0);
+    const std::size_t end = std::min(size, (chunk + 1) * chunk_size);
+    for (std::size_t i = chunk * chunk_size; i < end; ++i) {
+      const float column = std::floor(x[i] - x0);
+      const float row = std::floor(y[i] - y0);
+      // False for NaN
+      if ((column >= 0.0f) && (column < fwidth) && (row >= 0.0f) &&
+          (row < fheight)) {
+        ++counts[static_cast<std::size_t>(row) * width +
+                 static_cast<std::size_t>(column)];
+      }
+    }
+  });
+
+  Grid grid{width, height, std::move(chunk_counts[0])};
+  for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+    for (std::size_t i = 0; i < grid.counts.size(); ++i) {
+      grid.counts[i] += chunk_counts[chunk][i];
+    }
+  }
+  return grid;
+}
+
+std::vector<std::uint8_t> Colorize(const Grid &grid,
+                                   const std::vector<Color> &colormap) {
+  std::vector<std::uint8_t> rgba(4 * grid.counts.size(), 0);
+  if (grid.counts.empty() || colormap.empty()) {
+    return rgba;
+  }
+
+  const std::uint32_t max_count =
+      *std::max_element(grid.counts.begin(), grid.counts.end());
+  const double log_max = std::log1p(static_cast<double>(max_count));
+  const double last_color = static_cast<double>(colormap.size() - 1);
+  for (std::size_t i = 0; i < grid.counts.size(); ++i) {
+    const std::uint32_t count = grid.counts[i];
+    if (count == 0) {
+      continue;
+    }
+
+    const double position =
+        last_color * std::log1p(static_cast<double>(count)) / log_max;
+    const auto index = std::min(static_cast<std::size_t>(position),
+                                colormap.size() - 1);
+    const Color &low = colormap[index];
+    const Color &high = colormap[std::min(index + 1, colormap.size() - 1)];
+    const double t = position - static_cast<double>(index);
+    const auto mix = [t](std::uint8_t a, std::uint8_t b) {
+      return static_cast<std::uint8_t>(
+          std::lround(static_cast<double>(a) +
+                      t * (static_cast<double>(b) - static_cast<double>(a))));
+    };
+
+    rgba[4 * i] = mix(low.r, high.r);
+    rgba[4 * i + 1] = mix(low.g, high.g);
+    rgba[4 * i + 2] = mix(low.b, high.b);
+    rgba[4 * i + 3] = 255;
+  }
+  return rgba;
+}
+
+} // namespace density
+} // namespace plotcpp
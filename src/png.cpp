@@ -0,0 +1,116 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "png.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace plotcpp {
+namespace png {
+
+static void AppendUint32(std::string &out, std::uint32_t value) {
+  out += static_cast<char>((value >> 24) & 0xff);
+  out += static_cast<char>((value >> 16) & 0xff);
+  out += static_cast<char>((value >> 8) & 0xff);
+  out += static_cast<char>(value & 0xff);
+}
+
+/** Append a chunk: length, type, data and the CRC of type and data */
+static void AppendChunk(std::string &out, const char *type,
+                        const std::uint8_t *data, std::size_t size) {
+  AppendUint32(out, static_cast<std::uint32_t>(size));
+  const std::size_t type_start = out.size();
+  out.append(type, 4);
+  out.append(reinterpret_cast<const char *>(data), size);
+
+  const auto *crc_data =
+      reinterpret_cast<const Bytef *>(out.data() + type_start);
+  const uLong crc = crc32(crc32(0L, Z_NULL, 0), crc_data,
+                          static_cast<uInt>(out.size() - type_start));
+  AppendUint32(out, static_cast<std::uint32_t>(crc));
+}
+
+std::string Encode(const std::uint8_t *rgba, std::size_t width,
+                   std::size_t height) {
+  static constexpr std::uint8_t SIGNATURE[] = {0x89, 'P',  'N',  'G',
+                                               '\r', '\n', 0x1a, '\n'};
+  static constexpr std::uint8_t RGBA_COLOR_TYPE = 6;
+
+  // Every row starts with its filter type, which is 0 (none)
+  const std::size_t row_size = 4 * width;
+  std::vector<std::uint8_t> raw((row_size + 1) * height);
+  for (std::size_t row = 0; row < height; ++row) {
+    std::uint8_t *raw_row = &raw[row * (row_size + 1)];
+    raw_row[0] = 0;
+    std::copy_n(&rgba[row * row_size], row_size, &raw_row[1]);
+  }
+
+  uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+  std::vector<std::uint8_t> compressed(compressed_size);
+  if (compress(compressed.data(), &compressed_size, raw.data(),
+               static_cast<uLong>(raw.size())) != Z_OK) {
+    return {};
+  }
+
+  std::string out(reinterpret_cast<const char *>(SIGNATURE),
+                  sizeof(SIGNATURE));
+
+  std::string header;
+  AppendUint32(header, static_cast<std::uint32_t>(width));
+  AppendUint32(header, static_cast<std::uint32_t>(height));
+  // Bit depth, color type, compression, filter and interlace methods
+  header += static_cast<char>(8);
+  header += static_cast<char>(RGBA_COLOR_TYPE);
+  header.append(3, '\0');
+  AppendChunk(out, "IHDR",
+              reinterpret_cast<const std::uint8_t *>(header.data()),
+              header.size());
+  AppendChunk(out, "IDAT", compressed.data(), compressed_size);
+  AppendChunk(out, "IEND", nullptr, 0);
+  return out;
+}
+
+std::string DataUri(const std::string &png) {
+  static constexpr char ALPHABET[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  std::string uri = "data:image/png;base64,";
+  uri.reserve(uri.size() + 4 * ((png.size() + 2) / 3));
+
+  const auto byte = [&png](std::size_t i) -> std::uint32_t {
+    return (i < png.size()) ? static_cast<std::uint8_t>(png[i]) : 0;
+  };
+  for (std::size_t i = 0; i < png.size(); i += 3) {
+    const std::uint32_t group = (byte(i) << 16) | (byte(i + 1) << 8) |
+                                byte(i + 2);
+    uri += ALPHABET[(group >> 18) & 0x3f];
+    uri += ALPHABET[(group >> 12) & 0x3f];
+    uri += (i + 1 < png.size()) ? ALPHABET[(group >> 6) & 0x3f] : '=';
+    uri += (i + 2 < png.size()) ? ALPHABET[group & 0x3f] : '=';
+  }
+  return uri;
+}
+
+} // namespace png
+} // namespace plotcpp
@@ -0,0 +1,204 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reduction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "DataArray.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PLOTCPP_AVX2_DISPATCH
+#endif
+
+namespace plotcpp {
+namespace reduction {
+
+/** Scalar reduction. Integer values are always finite. */
+template <typename T>
+static ranges::Interval<Real> ScalarFiniteRange(std::span<const T> values) {
+  T min = std::numeric_limits<T>::max();
+  T max = std::numeric_limits<T>::lowest();
+  bool found = false;
+  for (const T value : values) {
+    if constexpr (std::is_floating_point_v<T>) {
+      // False for NaN
+      if (!(std::abs(value) <= std::numeric_limits<T>::max())) {
+        continue;
+      }
+    }
+    min = std::min(value, min);
+    max = std::max(value, max);
+    found = true;
+  }
+
+  if (!found) {
+    return EMPTY_RANGE;
+  }
+  return {static_cast<Real>(min), static_cast<Real>(max)};
+}
+
+#ifdef PLOTCPP_AVX2_DISPATCH
+__attribute__((target("avx2"))) static ranges::Interval<Real>
+Avx2FiniteRange(std::span<const double> values) {
+  constexpr std::size_t LANES = 4;
+  const std::size_t size = values.size();
+  const double *data = values.data();
+
+  const __m256d infinity =
+      _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  const __m256d abs_mask =
+      _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+  __m256d min = infinity;
+  __m256d max = _mm256_sub_pd(_mm256_setzero_pd(), infinity);
+
+  std::size_t i = 0;
+  for (; i + LANES <= size; i += LANES) {
+    const __m256d value = _mm256_loadu_pd(&data[i]);
+    // Ordered comparison, false for NaN
+    const __m256d finite =
+        _mm256_cmp_pd(_mm256_and_pd(value, abs_mask), infinity, _CMP_LT_OQ);
+    min = _mm256_min_pd(min, _mm256_blendv_pd(min, value, finite));
+    max = _mm256_max_pd(max, _mm256_blendv_pd(max, value, finite));
+  }
+
+  alignas(32) double lane_min[LANES];
+  alignas(32) double lane_max[LANES];
+  _mm256_store_pd(lane_min, min);
+  _mm256_store_pd(lane_max, max);
+  ranges::Interval<Real> range =
+      ScalarFiniteRange(values.subspan(i, size - i));
+  for (std::size_t lane = 0; lane < LANES; ++lane) {
+    if (lane_min[lane] <= lane_max[lane]) {
+      range.first = std::min(range.first, lane_min[lane]);
+      range.second = std::max(range.second, lane_max[lane]);
+    }
+  }
+  return range;
+}
+
+__attribute__((target("avx2"))) static ranges::Interval<Real>
+Avx2FiniteRange(std::span<const float> values) {
+  constexpr std::size_t LANES = 8;
+  const std::size_t size = values.size();
+  const float *data = values.data();
+
+  const __m256 infinity =
+      _mm256_set1_ps(std::numeric_limits<float>::infinity());
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 min = infinity;
+  __m256 max = _mm256_sub_ps(_mm256_setzero_ps(), infinity);
+
+  std::size_t i = 0;
+  for (; i + LANES <= size; i += LANES) {
+    const __m256 value = _mm256_loadu_ps(&data[i]);
+    // Ordered comparison, false for NaN
+    const __m256 finite =
+        _mm256_cmp_ps(_mm256_and_ps(value, abs_mask), infinity, _CMP_LT_OQ);
+    min = _mm256_min_ps(min, _mm256_blendv_ps(min, value, finite));
+    max = _mm256_max_ps(max, _mm256_blendv_ps(max, value, finite));
+  }
+
+  alignas(32) float lane_min[LANES];
+  alignas(32) float lane_max[LANES];
+  _mm256_store_ps(lane_min, min);
+  _mm256_store_ps(lane_max, max);
+  ranges::Interval<Real> range =
+      ScalarFiniteRange(values.subspan(i, size - i));
+  for (std::size_t lane = 0; lane < LANES; ++lane) {
+    if (lane_min[lane] <= lane_max[lane]) {
+      range.first = std::min(range.first, static_cast<Real>(lane_min[lane]));
+      range.second = std::max(range.second, static_cast<Real>(lane_max[lane]));
+    }
+  }
+  return range;
+}
+
+static bool HasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+#endif
+
+/** Reduce with AVX2 if the type has a kernel and the CPU supports it */
+template <typename T>
+static ranges::Interval<Real> DispatchFiniteRange(std::span<const T> values) {
+#ifdef PLOTCPP_AVX2_DISPATCH
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    if (HasAvx2()) {
+      return Avx2FiniteRange(values);
+    }
+  }
+#endif
+  return ScalarFiniteRange(values);
+}
+
+ranges::Interval<Real> FiniteRange(std::span<const Real> values) {
+  return DispatchFiniteRange(values);
+}
+
+ranges::Interval<Real> FiniteRange(const DataArray &values) {
+  return values.Visit([](auto view) { return DispatchFiniteRange(view); });
+}
+
+bool IsSorted(const DataArray &values) {
+  return values.Visit([](auto view) {
+    for (std::size_t i = 1; i < view.size(); ++i) {
+      // False for NaN
+      if (!(view[i] >= view[i - 1])) {
+        return false;
+      }
+    }
+    if constexpr (std::is_floating_point_v<
+                      typename decltype(view)::value_type>) {
+      return view.empty() || !std::isnan(view[0]);
+    }
+    return true;
+  });
+}
+
+std::pair<std::size_t, std::size_t>
+SortedWindow(const DataArray &values, const ranges::Interval<Real> &interval) {
+  return values.Visit([&](auto view) {
+    using T = typename decltype(view)::value_type;
+    const auto first = std::lower_bound(
+        view.begin(), view.end(), interval.first,
+        [](T value, Real bound) { return static_cast<Real>(value) < bound; });
+    const auto last = std::upper_bound(
+        first, view.end(), interval.second,
+        [](Real bound, T value) { return bound < static_cast<Real>(value); });
+    return std::pair<std::size_t, std::size_t>(
+        static_cast<std::size_t>(first - view.begin()),
+        static_cast<std::size_t>(last - view.begin()));
+  });
+}
+
+ranges::Interval<Real> Combine(const ranges::Interval<Real> &a,
+                               const ranges::Interval<Real> &b) {
+  return {std::min(a.first, b.first), std::max(a.second, b.second)};
+}
+
+} // namespace reduction
+} // namespace plotcpp
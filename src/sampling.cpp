@@ -0,0 +1,454 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace plotcpp {
+namespace sampling {
+
+/** Squared distance from a point to the segment between a and b */
+static double SquaredSegmentDistance(double px, double py, double ax,
+                                     double ay, double bx, double by) {
+  const double dx = bx - ax;
+  const double dy = by - ay;
+  const double length2 = dx * dx + dy * dy;
+
+  double t = 0.0;
+  if (length2 > 0.0) {
+    t = std::clamp(((px - ax) * dx + (py - ay) * dy) / length2, 0.0, 1.0);
+  }
+
+  const double ex = px - (ax + t * dx);
+  const double ey = py - (ay + t * dy);
+  return ex * ex + ey * ey;
+}
+
+/** Area of the triangle formed by three points */
+static double TriangleArea(double ax, double ay, double bx, double by,
+                           double cx, double cy) {
+  return 0.5 * std::abs((bx - ax) * (cy - ay) - (cx - ax) * (by - ay));
+}
+
+/** Move the kept points to the front of the arrays */
+static std::size_t Compact(float *x, float *y, const std::vector<bool> &keep) {
+  std::size_t num_kept = 0;
+  for (std::size_t i = 0; i < keep.size(); ++i) {
+    if (keep[i]) {
+      x[num_kept] = x[i];
+      y[num_kept] = y[i];
+      ++num_kept;
+    }
+  }
+  return num_kept;
+}
+
+std::size_t SimplifyDouglasPeucker(float *x, float *y, std::size_t size,
+                                   float tolerance) {
+  if (size <= 2) {
+    return size;
+  }
+
+  std::vector<bool> keep(size, false);
+  keep.front() = true;
+  keep.back() = true;
+
+  const double tolerance2 =
+      static_cast<double>(tolerance) * static_cast<double>(tolerance);
+
+  // Spans are processed with an explicit stack to support long polylines
+  std::vector<std::pair<std::size_t, std::size_t>> spans{{0, size - 1}};
+  while (!spans.empty()) {
+    const auto [first, last] = spans.back();
+    spans.pop_back();
+
+    double max_distance2 = 0.0;
+    std::size_t farthest = first;
+    for (std::size_t i = first + 1; i < last; ++i) {
+      const double distance2 =
+          SquaredSegmentDistance(x[i], y[i], x[first], y[first], x[last],
+                                 y[last]);
+      if (distance2 > max_distance2) {
+        max_distance2 = distance2;
+        farthest = i;
+      }
+    }
+
+    if (max_distance2 > tolerance2) {
+      keep[farthest] = true;
+      if (farthest - first > 1) {
+        spans.emplace_back(first, farthest);
+      }
+      if (last - farthest > 1) {
+        spans.emplace_back(farthest, last);
+      }
+    }
+  }
+
+  return Compact(x, y, keep);
+}
+
+std::size_t SimplifyVisvalingam(float *x, float *y, std::size_t size,
+                                float tolerance) {
+  if (size <= 2) {
+    return size;
+  }
+
+  const double min_area =
+      static_cast<double>(tolerance) * static_cast<double>(tolerance);
+
+  std::vector<std::size_t> prev(size);
+  std::vector<std::size_t> next(size);
+  std::vector<double> areas(size, 0.0);
+  std::vector<bool> keep(size, true);
+
+  const auto area_of = [&](std::size_t i) {
+    return TriangleArea(x[prev[i]], y[prev[i]], x[i], y[i], x[next[i]],
+                        y[next[i]]);
+  };
+
+  using Entry = std::pair<double, std::size_t>;
+  std::vector<Entry> entries;
+  entries.reserve(size - 2);
+  for (std::size_t i = 1; i + 1 < size; ++i) {
+    prev[i] = i - 1;
+    next[i] = i + 1;
+    areas[i] = area_of(i);
+    entries.emplace_back(areas[i], i);
+  }
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue(
+      std::greater<Entry>{}, std::move(entries));
+
+  while (!queue.empty()) {
+    const auto [area, i] = queue.top();
+    queue.pop();
+
+    // Entries of removed points and outdated areas are skipped
+    if (!keep[i] || (area != areas[i])) {
+      continue;
+    }
+    if (area >= min_area) {
+      break;
+    }
+
+    keep[i] = false;
+    const std::size_t p = prev[i];
+    const std::size_t n = next[i];
+    next[p] = n;
+    prev[n] = p;
+
+    // The area of a neighbour never decreases below the area of a removed
+    // point, so that points are removed in order of significance
+    for (const std::size_t neighbour : {p, n}) {
+      if ((neighbour == 0) || (neighbour == size - 1)) {
+        continue;
+      }
+      areas[neighbour] = std::max(area_of(neighbour), area);
+      queue.emplace(areas[neighbour], neighbour);
+    }
+  }
+
+  return Compact(x, y, keep);
+}
+
+/** Minimum and maximum of a sequence with the index of their first
+ * occurrence */
+struct Extrema {
+  float min = std::numeric_limits<float>::infinity();
+  std::size_t min_index = 0;
+  float max = -std::numeric_limits<float>::infinity();
+  std::size_t max_index = 0;
+
+  void Update(float value, std::size_t index) {
+    if ((value < min) || ((value == min) && (index < min_index))) {
+      min = value;
+      min_index = index;
+    }
+    if ((value > max) || ((value == max) && (index < max_index))) {
+      max = value;
+      max_index = index;
+    }
+  }
+};
+
+/** Maximum number of values reduced at once, so that lane indices fit in 32
+ * bits */
+static constexpr std::size_t MAX_REDUCTION_SIZE = std::size_t{1} << 30;
+
+/**
+ * @brief Find the extrema of a sequence in a single pass. The vector lanes
+ * keep their own extrema and indices, which are merged at the end. NaN
+ * values are ignored.
+ */
+static Extrema ReduceExtrema(const float *y, std::size_t size) {
+  Extrema extrema;
+  std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+  constexpr std::size_t LANES = 4;
+  alignas(16) float lane_min[LANES];
+  alignas(16) float lane_max[LANES];
+  alignas(16) std::int32_t lane_min_index[LANES];
+  alignas(16) std::int32_t lane_max_index[LANES];
+
+  if (size >= LANES) {
+#if defined(__SSE2__)
+    __m128 min = _mm_set1_ps(extrema.min);
+    __m128 max = _mm_set1_ps(extrema.max);
+    __m128i min_index = _mm_setzero_si128();
+    __m128i max_index = _mm_setzero_si128();
+    __m128i index = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i step = _mm_set1_epi32(LANES);
+    for (; i + LANES <= size; i += LANES) {
+      const __m128 value = _mm_loadu_ps(&y[i]);
+      const __m128 is_min = _mm_cmplt_ps(value, min);
+      const __m128 is_max = _mm_cmpgt_ps(value, max);
+      min = _mm_min_ps(value, min);
+      max = _mm_max_ps(value, max);
+      const __m128i min_mask = _mm_castps_si128(is_min);
+      const __m128i max_mask = _mm_castps_si128(is_max);
+      min_index = _mm_or_si128(_mm_and_si128(min_mask, index),
+                               _mm_andnot_si128(min_mask, min_index));
+      max_index = _mm_or_si128(_mm_and_si128(max_mask, index),
+                               _mm_andnot_si128(max_mask, max_index));
+      index = _mm_add_epi32(index, step);
+    }
+    _mm_store_ps(lane_min, min);
+    _mm_store_ps(lane_max, max);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lane_min_index), min_index);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lane_max_index), max_index);
+#else
+    float32x4_t min = vdupq_n_f32(extrema.min);
+    float32x4_t max = vdupq_n_f32(extrema.max);
+    int32x4_t min_index = vdupq_n_s32(0);
+    int32x4_t max_index = vdupq_n_s32(0);
+    const std::int32_t first_index[LANES] = {0, 1, 2, 3};
+    int32x4_t index = vld1q_s32(first_index);
+    const int32x4_t step = vdupq_n_s32(LANES);
+    for (; i + LANES <= size; i += LANES) {
+      const float32x4_t value = vld1q_f32(&y[i]);
+      const uint32x4_t is_min = vcltq_f32(value, min);
+      const uint32x4_t is_max = vcgtq_f32(value, max);
+      min = vbslq_f32(is_min, value, min);
+      max = vbslq_f32(is_max, value, max);
+      min_index = vbslq_s32(is_min, index, min_index);
+      max_index = vbslq_s32(is_max, index, max_index);
+      index = vaddq_s32(index, step);
+    }
+    vst1q_f32(lane_min, min);
+    vst1q_f32(lane_max, max);
+    vst1q_s32(lane_min_index, min_index);
+    vst1q_s32(lane_max_index, max_index);
+#endif
+
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      // Lanes without any valid value keep the initial extrema
+      if (lane_min[lane] <= lane_max[lane]) {
+        extrema.Update(lane_min[lane],
+                       static_cast<std::size_t>(lane_min_index[lane]));
+        extrema.Update(lane_max[lane],
+                       static_cast<std::size_t>(lane_max_index[lane]));
+      }
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    extrema.Update(y[i], i);
+  }
+
+  return extrema;
+}
+
+std::size_t DecimateM4(float *x, float *y, std::size_t size, float x_min,
+                       float x_max) {
+  const auto column_of = [x_min, x_max](float value) {
+    return static_cast<std::int64_t>(std::clamp(value, x_min, x_max) - x_min);
+  };
+
+  std::size_t num_kept = 0;
+  std::size_t start = 0;
+  while (start < size) {
+    const std::int64_t column = column_of(x[start]);
+    std::size_t end = start + 1;
+    while ((end < size) && (column_of(x[end]) == column)) {
+      ++end;
+    }
+
+    // Indices of the first, minimum, maximum and last points of the column
+    std::size_t kept[4] = {start, start, start, end - 1};
+    std::size_t num_column_kept = 0;
+    if (end - start <= 4) {
+      for (std::size_t i = start; i < end; ++i) {
+        kept[num_column_kept++] = i;
+      }
+    } else {
+      Extrema extrema;
+      for (std::size_t offset = start; offset < end;
+           offset += MAX_REDUCTION_SIZE) {
+        const std::size_t count = std::min(MAX_REDUCTION_SIZE, end - offset);
+        const Extrema chunk = ReduceExtrema(&y[offset], count);
+        if (chunk.min <= chunk.max) {
+          extrema.Update(chunk.min, offset + chunk.min_index);
+          extrema.Update(chunk.max, offset + chunk.max_index);
+        }
+      }
+
+      kept[1] = std::min(extrema.min_index, extrema.max_index);
+      kept[2] = std::max(extrema.min_index, extrema.max_index);
+      if (extrema.min > extrema.max) {
+        // All values are NaN
+        kept[1] = kept[2] = start;
+      }
+      num_column_kept =
+          static_cast<std::size_t>(std::unique(kept, kept + 4) - kept);
+    }
+
+    // The kept points are read before writing, since the output never
+    // overtakes the column being reduced
+    float kept_x[4];
+    float kept_y[4];
+    for (std::size_t i = 0; i < num_column_kept; ++i) {
+      kept_x[i] = x[kept[i]];
+      kept_y[i] = y[kept[i]];
+    }
+    for (std::size_t i = 0; i < num_column_kept; ++i) {
+      x[num_kept] = kept_x[i];
+      y[num_kept] = kept_y[i];
+      ++num_kept;
+    }
+
+    start = end;
+  }
+
+  return num_kept;
+}
+
+std::size_t DownsampleLTTB(float *x, float *y, std::size_t size,
+                           std::size_t max_points) {
+  max_points = std::max(max_points, std::size_t{2});
+  if (size <= max_points) {
+    return size;
+  }
+
+  const std::size_t num_buckets = max_points - 2;
+  const auto bucket_start = [&](std::size_t bucket) {
+    return 1 + (bucket * (size - 2)) / num_buckets;
+  };
+
+  // The kept points are written behind the bucket being read, so the
+  // previous kept point is held separately
+  double prev_x = x[0];
+  double prev_y = y[0];
+  std::size_t num_kept = 1;
+  for (std::size_t bucket = 0; bucket < num_buckets; ++bucket) {
+    const std::size_t start = bucket_start(bucket);
+    const std::size_t end = bucket_start(bucket + 1);
+
+    // Average of the next bucket, which is the last point for the last one
+    const std::size_t next_start = end;
+    const std::size_t next_end =
+        (bucket + 1 < num_buckets) ? bucket_start(bucket + 2) : size;
+    double next_x = 0.0;
+    double next_y = 0.0;
+    for (std::size_t i = next_start; i < next_end; ++i) {
+      next_x += x[i];
+      next_y += y[i];
+    }
+    const double next_count = static_cast<double>(next_end - next_start);
+    next_x /= next_count;
+    next_y /= next_count;
+
+    std::size_t selected = start;
+    double max_area = -1.0;
+    for (std::size_t i = start; i < end; ++i) {
+      const double area =
+          TriangleArea(prev_x, prev_y, x[i], y[i], next_x, next_y);
+      if (area > max_area) {
+        max_area = area;
+        selected = i;
+      }
+    }
+
+    prev_x = x[selected];
+    prev_y = y[selected];
+    x[num_kept] = x[selected];
+    y[num_kept] = y[selected];
+    ++num_kept;
+  }
+
+  x[num_kept] = x[size - 1];
+  y[num_kept] = y[size - 1];
+  return num_kept + 1;
+}
+
+std::size_t RemoveOverdrawn(float *x, float *y, std::size_t size, float x_min,
+                            float y_min, float x_max, float y_max,
+                            std::size_t subpixels) {
+  const auto scale = static_cast<float>(subpixels);
+  const float columns = std::ceil((x_max - x_min) * scale);
+  const float rows = std::ceil((y_max - y_min) * scale);
+  // False for NaN
+  if (!((columns > 0.0f) && (rows > 0.0f))) {
+    return size;
+  }
+
+  const auto width = static_cast<std::size_t>(columns);
+  const auto height = static_cast<std::size_t>(rows);
+  std::vector<std::uint64_t> occupied((width * height + 63) / 64, 0);
+
+  std::size_t num_kept = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    const float column = std::floor((x[i] - x_min) * scale);
+    const float row = std::floor((y[i] - y_min) * scale);
+    if ((column >= 0.0f) && (column < columns) && (row >= 0.0f) &&
+        (row < rows)) {
+      const std::size_t cell = static_cast<std::size_t>(row) * width +
+                               static_cast<std::size_t>(column);
+      const std::uint64_t bit = std::uint64_t{1} << (cell % 64);
+      if (occupied[cell / 64] & bit) {
+        continue;
+      }
+      occupied[cell / 64] |= bit;
+    }
+
+    x[num_kept] = x[i];
+    y[num_kept] = y[i];
+    ++num_kept;
+  }
+
+  return num_kept;
+}
+
+} // namespace sampling
+} // namespace plotcpp
@@ -18,6 +18,12 @@
 
 #include "svg.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <utility>
+
 #include "libxml/tree.h"
 
 namespace plotcpp {
@@ -27,26 +33,158 @@ static inline const xmlChar *xchar(const char *str) {
   return (const xmlChar *)str;
 }
 
-xmlNode *AppendNode(xmlNode *parent, const std::string &name) {
+/** Append text to a buffer escaping the XML special characters */
+static void AppendEscaped(std::string &out, const std::string &text) {
+  std::size_t start = 0;
+  while (true) {
+    const std::size_t pos = text.find_first_of("&<>\"", start);
+    if (pos == std::string::npos) {
+      out.append(text, start);
+      return;
+    }
+
+    out.append(text, start, pos - start);
+    switch (text[pos]) {
+    case '&':
+      out += "&amp;";
+      break;
+    case '<':
+      out += "&lt;";
+      break;
+    case '>':
+      out += "&gt;";
+      break;
+    default:
+      out += "&quot;";
+    }
+    start = pos + 1;
+  }
+}
+
+/**
+ * Set an attribute in a serialized start tag, replacing the attribute if it
+ * was already present. The tag starts at tag_offset and ends at the end of
+ * the buffer.
+ */
+static void AppendAttribute(std::string &out, std::size_t tag_offset,
+                            const std::string &name, const std::string &value) {
+  const std::string key = " " + name + "=\"";
+  const std::size_t pos = out.find(key, tag_offset);
+  if (pos != std::string::npos) {
+    const std::size_t end = out.find('"', pos + key.size());
+    out.erase(pos, end + 1 - pos);
+  }
+
+  out += key;
+  AppendEscaped(out, value);
+  out += '"';
+}
+
+/** Serialize a libxml2 node into a buffer */
+static void AppendXmlNode(std::string &out, xmlNodePtr node, int level,
+                          bool format) {
+  xmlBufferPtr buffer = xmlBufferCreate();
+  xmlNodeDump(buffer, node->doc, node, level, format ? 1 : 0);
+  out.append((const char *)xmlBufferContent(buffer),
+             static_cast<std::size_t>(xmlBufferLength(buffer)));
+  xmlBufferFree(buffer);
+}
+
+Node AppendNode(Node parent, const std::string &name) {
+  if (parent.document != nullptr) {
+    return parent.document->StreamOpen(parent, name);
+  }
+
   xmlNode *new_node = xmlNewNode(nullptr, xchar(name.c_str()));
-  xmlAddChild(parent, new_node);
+  xmlAddChild(parent.xml, new_node);
   return new_node;
 }
 
-void SetAttribute(xmlNode *node, const std::string &name,
-                  const std::string &value, const std::string &unit) {
-  const std::string val_str = value + unit;
-  xmlSetProp(node, xchar(name.c_str()), xchar(val_str.c_str()));
+void SetAttribute(Node node, const std::string &name, const std::string &value,
+                  const std::string &unit) {
+  if (!unit.empty()) {
+    SetAttribute(node, name, value + unit);
+    return;
+  }
+
+  if (node.document != nullptr) {
+    node.document->StreamSetAttribute(node.id, name, value);
+    return;
+  }
+
+  xmlSetProp(node.xml, xchar(name.c_str()), xchar(value.c_str()));
+}
+
+void SetContent(Node node, const std::string &content) {
+  if (node.document != nullptr) {
+    node.document->StreamSetContent(node.id, content);
+    return;
+  }
+
+  // xmlNodeAddContent escapes the text, unlike xmlNodeSetContent
+  xmlNodeSetContent(node.xml, nullptr);
+  xmlNodeAddContent(node.xml, xchar(content.c_str()));
+}
+
+void AppendNumber(std::string &out, float value, int precision) {
+  char buffer[64];
+  char *const end = buffer + sizeof(buffer);
+  std::to_chars_result result;
+
+  if (precision < 0) {
+    result = std::to_chars(buffer, end, value);
+  } else {
+    result = std::to_chars(buffer, end, value, std::chars_format::fixed,
+                           std::min(precision, MAX_PRECISION));
+
+    // Trim trailing zeros and the decimal point
+    if ((result.ec == std::errc{}) &&
+        (std::find(buffer, result.ptr, '.') != result.ptr)) {
+      while (*(result.ptr - 1) == '0') {
+        --result.ptr;
+      }
+      if (*(result.ptr - 1) == '.') {
+        --result.ptr;
+      }
+    }
+  }
+
+  // Negative values that round to zero are written as 0
+  const bool is_negative_zero =
+      (result.ptr - buffer == 2) && (buffer[0] == '-') && (buffer[1] == '0');
+  if ((result.ec != std::errc{}) || is_negative_zero) {
+    out += '0';
+    return;
+  }
+
+  out.append(buffer, result.ptr);
+}
+
+std::string FormatNumber(float value, int precision) {
+  std::string str;
+  AppendNumber(str, value, precision);
+  return str;
+}
+
+/** Append an integer to a buffer */
+static void AppendInteger(std::string &out, unsigned int value) {
+  char buffer[16];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
 }
 
 std::string ColorToString(const Color &color) {
-  std::stringstream ss;
-  ss << "RGB(" << std::to_string(color.r) << ", " << std::to_string(color.g)
-     << ", " << std::to_string(color.b) << ")";
-  return ss.str();
+  std::string str{"RGB("};
+  AppendInteger(str, color.r);
+  str += ", ";
+  AppendInteger(str, color.g);
+  str += ", ";
+  AppendInteger(str, color.b);
+  str += ')';
+  return str;
 }
 
-Document::Document() {
+Document::Document(Backend backend) : m_backend(backend) {
   m_doc = xmlNewDoc(xchar("1.0"));
   Reset();
 }
@@ -55,84 +193,469 @@ Document::~Document() { xmlFreeDoc(m_doc); }
 
 xmlDocPtr Document::GetDoc() { return m_doc; }
 
+Document::Backend Document::GetBackend() const { return m_backend; }
+
+void Document::SetBackend(Backend backend) {
+  m_backend = backend;
+  Reset();
+}
+
+void Document::SetPrecision(int precision) {
+  m_precision = std::clamp(precision, SHORTEST_PRECISION, MAX_PRECISION);
+}
+
+int Document::GetPrecision() const { return m_precision; }
+
+void Document::SetCompact(bool compact) { m_compact = compact; }
+
+bool Document::IsCompact() const { return m_compact; }
+
+std::string Document::FormatNumber(float value) const {
+  return svg::FormatNumber(value, m_precision);
+}
+
 std::string Document::GetText() const {
-  xmlChar *xml_str;
-  xmlDocDumpFormatMemory(m_doc, &xml_str, nullptr, 1);
-  return std::string{(char *)xml_str};
+  std::string text;
+  Write([&text](const char *data, std::size_t size) {
+    text.append(data, size);
+  });
+  return text;
+}
+
+/** libxml2 output callback that forwards the serialized text to a writer */
+static int WriteXmlOutput(void *context, const char *buffer, int len) {
+  const auto *writer = static_cast<const Document::Writer *>(context);
+  (*writer)(buffer, static_cast<std::size_t>(len));
+  return len;
+}
+
+void Document::Write(const Writer &writer) const {
+  if (m_backend == Backend::STREAM) {
+    const auto write = [&writer](std::string_view text) {
+      writer(text.data(), text.size());
+    };
+
+    write("<?xml version=\"1.0\"?>\n<svg");
+    write(m_stream_root_attributes);
+    write(m_compact ? ">" : ">\n");
+    if (!m_styles.empty()) {
+      write(m_compact ? "<defs><style>" : "  <defs>\n    <style>");
+      write(StyleSheet());
+      write(m_compact ? "</style></defs>" : "</style>\n  </defs>\n");
+    }
+    StreamWriteBody(writer);
+    write("</svg>\n");
+    return;
+  }
+
+  xmlOutputBufferPtr output = xmlOutputBufferCreateIO(
+      WriteXmlOutput, nullptr, const_cast<Writer *>(&writer), nullptr);
+  if (output == nullptr) {
+    return;
+  }
+  xmlSaveFormatFileTo(output, m_doc, nullptr, m_compact ? 0 : 1);
 }
 
 std::pair<float, float> Document::GetSize() { return {m_width, m_height}; }
 
-std::string PathCommand::ToString() const {
-  std::stringstream ss;
+static constexpr std::string_view STYLE_CLASS_PREFIX = "s";
 
+/** Append a property to a style declaration */
+static void AppendProperty(std::string &declaration, const char *name,
+                           const std::string &value) {
+  declaration += name;
+  declaration += ':';
+  declaration += value;
+  declaration += ';';
+}
+
+/** Parses the number of a style class name. Returns false on failure. */
+static bool ParseStyleClass(std::string_view name, std::size_t *index) {
+  if (!name.starts_with(STYLE_CLASS_PREFIX)) {
+    return false;
+  }
+  name.remove_prefix(STYLE_CLASS_PREFIX.size());
+  const char *end = name.data() + name.size();
+  const auto result = std::from_chars(name.data(), end, *index);
+  return (result.ec == std::errc{}) && (result.ptr == end);
+}
+
+/**
+ * @brief Rename the style classes of a libxml2 subtree and remove its style
+ * sheets, which are replaced by the one of the document it is appended to.
+ */
+static void RenameStyleClasses(xmlNodePtr node,
+                               const std::vector<std::string> &classes) {
+  xmlChar *value = xmlGetProp(node, xchar("class"));
+  if (value != nullptr) {
+    std::size_t index;
+    if (ParseStyleClass((const char *)value, &index) &&
+        (index < classes.size())) {
+      xmlSetProp(node, xchar("class"), xchar(classes[index].c_str()));
+    }
+    xmlFree(value);
+  }
+
+  xmlNodePtr child = node->children;
+  while (child != nullptr) {
+    xmlNodePtr next = child->next;
+    if (child->type == XML_ELEMENT_NODE) {
+      if (xmlStrEqual(child->name, xchar("style"))) {
+        xmlUnlinkNode(child);
+        xmlFreeNode(child);
+      } else {
+        RenameStyleClasses(child, classes);
+      }
+    }
+    child = next;
+  }
+}
+
+/** Append serialized elements, renaming their style classes */
+static void
+AppendRenamingStyleClasses(std::string &out, std::string_view text,
+                           const std::vector<std::string> &classes) {
+  static constexpr std::string_view CLASS_ATTRIBUTE = " class=\"";
+
+  std::size_t start = 0;
+  while (true) {
+    const std::size_t pos = text.find(CLASS_ATTRIBUTE, start);
+    if (pos == std::string_view::npos) {
+      out.append(text.substr(start));
+      return;
+    }
+
+    const std::size_t value_start = pos + CLASS_ATTRIBUTE.size();
+    const std::size_t value_end = text.find('"', value_start);
+    if (value_end == std::string_view::npos) {
+      out.append(text.substr(start));
+      return;
+    }
+
+    out.append(text.substr(start, value_start - start));
+    const std::string_view value =
+        text.substr(value_start, value_end - value_start);
+    std::size_t index;
+    if (ParseStyleClass(value, &index) && (index < classes.size())) {
+      out += classes[index];
+    } else {
+      out.append(value);
+    }
+    start = value_end;
+  }
+}
+
+/** Returns the letter of a path command */
+static char PathCommandLetter(PathCommand::Id id) {
   switch (id) {
-  case Id::MOVE:
-    ss << "M";
-    break;
-  case Id::MOVE_R:
-    ss << "m";
-    break;
-  case Id::LINE:
-    ss << "L";
-    break;
-  case Id::LINE_R:
-    ss << "l";
-    break;
-  case Id::VERTICAL:
-    ss << "V";
-    break;
-  case Id::VERTICAL_R:
-    ss << "v";
-    break;
-  case Id::HORIZONTAL:
-    ss << "H";
-    break;
-  case Id::HORIZONTAL_R:
-    ss << "h";
-    break;
-  case Id::QUADRATIC_R:
-    ss << "q";
-    break;
-  case Id::CLOSE:
-    ss << "Z";
-  }
-
-  for (const auto &arg : args) {
-    ss << " " << std::to_string(arg);
-  }
-
-  return ss.str();
-}
-
-void Path::Add(const PathCommand &command) { commands.push_back(command); }
-
-void Path::Clear() { commands.clear(); }
+  case PathCommand::Id::MOVE:
+    return 'M';
+  case PathCommand::Id::MOVE_R:
+    return 'm';
+  case PathCommand::Id::LINE:
+    return 'L';
+  case PathCommand::Id::LINE_R:
+    return 'l';
+  case PathCommand::Id::VERTICAL:
+    return 'V';
+  case PathCommand::Id::VERTICAL_R:
+    return 'v';
+  case PathCommand::Id::HORIZONTAL:
+    return 'H';
+  case PathCommand::Id::HORIZONTAL_R:
+    return 'h';
+  case PathCommand::Id::QUADRATIC_R:
+    return 'q';
+  case PathCommand::Id::CLOSE:
+    return 'Z';
+  }
+
+  return 'Z';
+}
+
+void Path::Add(PathCommand::Id id, std::initializer_list<float> command_args) {
+  commands.push_back(id);
+  args.insert(args.end(), command_args);
+}
+
+void Path::AddPolyline(const float *x, const float *y, std::size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  Reserve(commands.size() + size, args.size() + 2 * size);
+  MoveTo(x[0], y[0]);
+  for (std::size_t i = 1; i < size; ++i) {
+    LineTo(x[i], y[i]);
+  }
+}
+
+void Path::Reserve(std::size_t num_commands, std::size_t num_args) {
+  commands.reserve(num_commands);
+  args.reserve(num_args);
+}
+
+void Path::Clear() {
+  commands.clear();
+  args.clear();
+}
+
+void Path::AppendData(std::string &out, int precision) const {
+  // Roughly 8 bytes per argument at pixel precision
+  out.reserve(out.size() + commands.size() + 8 * args.size());
+
+  const float *arg = args.data();
+  for (const PathCommand::Id id : commands) {
+    out += PathCommandLetter(id);
+
+    const std::size_t num_args = PathCommand::NumArgs(id);
+    for (std::size_t i = 0; i < num_args; ++i) {
+      if (i > 0) {
+        out += ' ';
+      }
+      AppendNumber(out, *arg++, precision);
+    }
+  }
+}
 
 void Document::Reset() {
   if (m_root != nullptr) {
     xmlUnlinkNode(m_root);
     xmlFreeNode(m_root);
+    m_root = nullptr;
+    m_defs = nullptr;
+    m_style = nullptr;
+  }
+
+  m_styles.clear();
+  m_style_classes.clear();
+
+  m_layers.clear();
+  m_layer = 0;
+
+  m_stream.clear();
+  m_stream_root_attributes.clear();
+  m_stream_open.clear();
+  m_stream_unlayered.clear();
+  m_stream_next_id = STREAM_ROOT_ID + 1;
+
+  if (m_backend == Backend::DOM) {
+    m_root = xmlNewNode(nullptr, xchar("svg"));
+    xmlDocSetRootElement(m_doc, m_root);
+
+    m_defs = AppendNode(m_root, "defs").xml;
+  }
+}
+
+Node Document::Root() {
+  if (m_backend == Backend::STREAM) {
+    return Node{this, STREAM_ROOT_ID};
+  }
+
+  if (!m_layers.empty()) {
+    return m_layers[m_layer].node;
   }
 
-  m_root = xmlNewNode(nullptr, xchar("svg"));
-  xmlDocSetRootElement(m_doc, m_root);
+  return m_root;
+}
+
+void Document::SelectLayer(std::size_t layer) {
+  if (m_backend == Backend::STREAM) {
+    while (!m_stream_open.empty()) {
+      StreamClose();
+    }
+
+    if (m_layers.empty()) {
+      // Elements drawn before any layer stay below all layers
+      m_stream_unlayered = std::move(m_stream);
+      m_stream.clear();
+      m_layers.emplace_back();
+    } else {
+      std::swap(m_stream, m_layers[m_layer].stream);
+    }
+  }
+
+  while (m_layers.size() <= layer) {
+    Layer new_layer;
+    if (m_backend == Backend::DOM) {
+      new_layer.node = AppendNode(m_root, "g").xml;
+    }
+    m_layers.push_back(std::move(new_layer));
+  }
+
+  m_layer = layer;
+  if (m_backend == Backend::STREAM) {
+    std::swap(m_stream, m_layers[m_layer].stream);
+  }
+}
+
+void Document::ClearLayer(std::size_t layer) {
+  if (layer >= m_layers.size()) {
+    return;
+  }
 
-  m_defs = AppendNode(m_root, "defs");
+  if (m_backend == Backend::STREAM) {
+    if (layer == m_layer) {
+      m_stream.clear();
+      m_stream_open.clear();
+    } else {
+      m_layers[layer].stream.clear();
+    }
+    return;
+  }
+
+  xmlNodePtr node = m_layers[layer].node;
+  while (node->children != nullptr) {
+    xmlNodePtr child = node->children;
+    xmlUnlinkNode(child);
+    xmlFreeNode(child);
+  }
+  m_layers[layer].defs = nullptr;
+}
+
+std::string Document::StyleClass(const std::string &declaration) {
+  auto [it, inserted] =
+      m_style_classes.try_emplace(declaration, m_styles.size());
+
+  std::string name{STYLE_CLASS_PREFIX};
+  name += std::to_string(it->second);
+
+  if (inserted) {
+    m_styles.push_back(declaration);
+
+    if (m_backend == Backend::DOM) {
+      if (m_style == nullptr) {
+        m_style = AppendNode(m_defs, "style").xml;
+      }
+      const std::string rule = "." + name + "{" + declaration + "}\n";
+      xmlNodeAddContent(m_style, xchar(rule.c_str()));
+    }
+  }
+
+  return name;
+}
+
+std::string Document::StyleSheet() const {
+  std::string sheet;
+  for (std::size_t i = 0; i < m_styles.size(); ++i) {
+    sheet += '.';
+    sheet += STYLE_CLASS_PREFIX;
+    sheet += std::to_string(i);
+    sheet += '{';
+    sheet += m_styles[i];
+    sheet += "}\n";
+  }
+  return sheet;
+}
+
+std::vector<std::string> Document::MergeStyles(const Document &document) {
+  std::vector<std::string> classes;
+  classes.reserve(document.m_styles.size());
+  for (const auto &declaration : document.m_styles) {
+    classes.push_back(StyleClass(declaration));
+  }
+  return classes;
 }
 
 void Document::SetSize(unsigned int width, unsigned int height) {
   m_width = width;
   m_height = height;
-  SetAttribute(m_root, "width", std::to_string(m_width));
-  SetAttribute(m_root, "height", std::to_string(m_height));
+  const Node root =
+      (m_backend == Backend::STREAM) ? Node{this, STREAM_ROOT_ID} : m_root;
+  SetAttribute(root, "width", std::to_string(m_width));
+  SetAttribute(root, "height", std::to_string(m_height));
 }
 
-void Document::Append(xmlNodePtr node) { xmlAddChild(m_root, node); }
+void Document::Append(xmlNodePtr node) {
+  if (m_backend == Backend::STREAM) {
+    while (!m_stream_open.empty()) {
+      StreamClose();
+    }
+    StreamIndent(m_stream, 1);
+    AppendXmlNode(m_stream, node, StreamDepth(1), !m_compact);
+    StreamLineBreak(m_stream);
+    xmlFreeNode(node);
+    return;
+  }
 
-xmlNodePtr Document::AddGroup(xmlNodePtr parent_node, const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "g");
+  xmlAddChild(Root().xml, node);
+}
+
+void Document::AppendDocument(const Document &document, unsigned int x,
+                              unsigned int y) {
+  // Style sheets apply to the whole document, so the nested document uses the
+  // classes of this one
+  const std::vector<std::string> classes = MergeStyles(document);
+
+  if ((m_backend == Backend::DOM) && (document.m_backend == Backend::DOM)) {
+    xmlNodePtr cloned_root = xmlCopyNode(document.m_root, 1);
+    RenameStyleClasses(cloned_root, classes);
+    SetAttribute(cloned_root, "x", std::to_string(x));
+    SetAttribute(cloned_root, "y", std::to_string(y));
+    Append(cloned_root);
+    return;
+  }
+
+  if (m_backend == Backend::DOM) {
+    // Parse the streamed text so that the nested document becomes a subtree
+    const std::string text = document.GetText();
+    xmlDocPtr parsed_doc = xmlReadMemory(text.c_str(),
+                                         static_cast<int>(text.size()),
+                                         nullptr, nullptr, XML_PARSE_NOBLANKS);
+    if (parsed_doc == nullptr) {
+      return;
+    }
+
+    xmlNodePtr cloned_root = xmlDocCopyNode(xmlDocGetRootElement(parsed_doc),
+                                            m_doc, 1);
+    xmlFreeDoc(parsed_doc);
+    RenameStyleClasses(cloned_root, classes);
+    SetAttribute(cloned_root, "x", std::to_string(x));
+    SetAttribute(cloned_root, "y", std::to_string(y));
+    Append(cloned_root);
+    return;
+  }
+
+  Node nested_root = StreamOpen(Root(), "svg");
+  if (document.m_backend == Backend::DOM) {
+    for (xmlAttrPtr attr = document.m_root->properties; attr != nullptr;
+         attr = attr->next) {
+      xmlChar *value = xmlNodeGetContent((xmlNodePtr)attr);
+      SetAttribute(nested_root, (const char *)attr->name,
+                   std::string{(const char *)value});
+      xmlFree(value);
+    }
+  } else {
+    m_stream += document.m_stream_root_attributes;
+  }
+  SetAttribute(nested_root, "x", std::to_string(x));
+  SetAttribute(nested_root, "y", std::to_string(y));
+  m_stream += '>';
+  StreamLineBreak(m_stream);
+  m_stream_open.back().tag_open = false;
+
+  if (document.m_backend == Backend::DOM) {
+    for (xmlNodePtr child = document.m_root->children; child != nullptr;
+         child = child->next) {
+      xmlNodePtr cloned_child = xmlCopyNode(child, 1);
+      RenameStyleClasses(cloned_child, classes);
+      StreamIndent(m_stream, 2);
+      AppendXmlNode(m_stream, cloned_child, StreamDepth(2), !m_compact);
+      StreamLineBreak(m_stream);
+      xmlFreeNode(cloned_child);
+    }
+  } else {
+    document.StreamWriteBody([&](const char *data, std::size_t size) {
+      AppendRenamingStyleClasses(m_stream, {data, size}, classes);
+    });
+  }
+
+  StreamClose();
+}
+
+Node Document::AddGroup(Node parent_node, const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "g");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
@@ -141,10 +664,38 @@ xmlNodePtr Document::AddGroup(xmlNodePtr parent_node, const std::string &id) {
   return node;
 }
 
-xmlNodePtr Document::Defs() { return m_defs; }
+Node Document::Defs() {
+  if (m_backend == Backend::STREAM) {
+    // Definitions are streamed in place. A <defs> element stays available
+    // until a new element is drawn at the root level.
+    while (m_stream_open.size() > 1) {
+      StreamClose();
+    }
+    if (!m_stream_open.empty() && (m_stream_open.front().name == "defs")) {
+      return Node{this, m_stream_open.front().id};
+    }
+
+    return StreamOpen(Root(), "defs");
+  }
+
+  if (!m_layers.empty()) {
+    Layer &layer = m_layers[m_layer];
+    if (layer.defs == nullptr) {
+      layer.defs = xmlNewNode(nullptr, xchar("defs"));
+      if (layer.node->children == nullptr) {
+        xmlAddChild(layer.node, layer.defs);
+      } else {
+        xmlAddPrevSibling(layer.node->children, layer.defs);
+      }
+    }
+    return layer.defs;
+  }
+
+  return m_defs;
+}
 
-xmlNodePtr Document::DrawBackground(Color color) {
-  auto *node = AppendNode(m_root, "rect");
+Node Document::DrawBackground(Color color) {
+  Node node = AppendNode(Root(), "rect");
 
   SetAttribute(node, "id", "_background");
 
@@ -153,123 +704,172 @@ xmlNodePtr Document::DrawBackground(Color color) {
   SetAttribute(node, "width", "100", "%");
   SetAttribute(node, "height", "100", "%");
 
-  std::stringstream style_value_ss;
-  style_value_ss << "stroke-opacity:"
-                 << "1.0"
-                 << "; "
-                 << "fill: " << ColorToString(color) << ";";
-  SetAttribute(node, "style", style_value_ss.str());
+  SetAttribute(node, "style",
+               "stroke-opacity:1.0; fill: " + ColorToString(color) + ";");
 
   return node;
 }
 
-xmlNodePtr Document::DrawLine(const Line &line, xmlNodePtr parent_node,
-                              const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "line");
+Node Document::DrawLine(const Line &line, Node parent_node,
+                        const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "line");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
   }
 
-  SetAttribute(node, "x1", std::to_string(line.x1));
-  SetAttribute(node, "y1", std::to_string(line.y1));
-  SetAttribute(node, "x2", std::to_string(line.x2));
-  SetAttribute(node, "y2", std::to_string(line.y2));
-  SetAttribute(node, "stroke", ColorToString(line.stroke_color));
-  SetAttribute(node, "stroke-width", std::to_string(line.stroke_width));
-  SetAttribute(node, "stroke-opacity", std::to_string(line.stroke_opacity));
+  SetAttribute(node, "x1", FormatNumber(line.x1));
+  SetAttribute(node, "y1", FormatNumber(line.y1));
+  SetAttribute(node, "x2", FormatNumber(line.x2));
+  SetAttribute(node, "y2", FormatNumber(line.y2));
+
+  std::string style;
+  AppendProperty(style, "stroke", ColorToString(line.stroke_color));
+  AppendProperty(style, "stroke-width", FormatNumber(line.stroke_width));
+  AppendProperty(style, "stroke-opacity", FormatNumber(line.stroke_opacity));
+  SetAttribute(node, "class", StyleClass(style));
 
   return node;
 }
 
-xmlNodePtr Document::DrawRect(const Rect &rect, xmlNodePtr parent_node,
-                              const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "rect");
+Node Document::DrawRect(const Rect &rect, Node parent_node,
+                        const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "rect");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
   }
 
-  SetAttribute(node, "x", std::to_string(rect.x));
-  SetAttribute(node, "y", std::to_string(rect.y));
-  SetAttribute(node, "width", std::to_string(rect.width));
-  SetAttribute(node, "height", std::to_string(rect.height));
-  SetAttribute(node, "rx", std::to_string(rect.rx));
-  SetAttribute(node, "ry", std::to_string(rect.ry));
-  SetAttribute(node, "stroke", ColorToString(rect.stroke_color));
-  SetAttribute(node, "stroke-width", std::to_string(rect.stroke_width));
-  SetAttribute(node, "stroke-opacity", std::to_string(rect.stroke_opacity));
+  SetAttribute(node, "x", FormatNumber(rect.x));
+  SetAttribute(node, "y", FormatNumber(rect.y));
+  SetAttribute(node, "width", FormatNumber(rect.width));
+  SetAttribute(node, "height", FormatNumber(rect.height));
+  SetAttribute(node, "rx", FormatNumber(rect.rx));
+  SetAttribute(node, "ry", FormatNumber(rect.ry));
 
+  std::string style;
+  AppendProperty(style, "stroke", ColorToString(rect.stroke_color));
+  AppendProperty(style, "stroke-width", FormatNumber(rect.stroke_width));
+  AppendProperty(style, "stroke-opacity", FormatNumber(rect.stroke_opacity));
   if (rect.fill_transparent == true) {
-    SetAttribute(node, "fill", "transparent");
+    AppendProperty(style, "fill", "none");
   } else {
-    SetAttribute(node, "fill", ColorToString(rect.fill_color));
-    SetAttribute(node, "fill-opacity", std::to_string(rect.fill_opacity));
+    AppendProperty(style, "fill", ColorToString(rect.fill_color));
+    AppendProperty(style, "fill-opacity", FormatNumber(rect.fill_opacity));
   }
+  SetAttribute(node, "class", StyleClass(style));
 
   return node;
 }
 
-xmlNodePtr Document::DrawCircle(const Circle &circle, xmlNodePtr parent_node,
-                                const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "circle");
+Node Document::DrawCircle(const Circle &circle, Node parent_node,
+                          const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "circle");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
   }
 
-  SetAttribute(node, "cx", std::to_string(circle.cx));
-  SetAttribute(node, "cy", std::to_string(circle.cy));
-  SetAttribute(node, "r", std::to_string(circle.r));
-  SetAttribute(node, "fill", ColorToString(circle.fill_color));
+  SetAttribute(node, "cx", FormatNumber(circle.cx));
+  SetAttribute(node, "cy", FormatNumber(circle.cy));
+  SetAttribute(node, "r", FormatNumber(circle.r));
+
+  std::string style;
+  AppendProperty(style, "fill", ColorToString(circle.fill_color));
+  SetAttribute(node, "class", StyleClass(style));
+
+  return node;
+}
+
+Node Document::DrawPath(const Path &path, Node parent_node,
+                        const std::string &id) {
+  Node node = AppendPath(path, parent_node, id);
+  SetPathData(node, path);
+  return node;
+}
 
+Node Document::DrawPath(const Path &path, const std::string &path_data,
+                        Node parent_node, const std::string &id) {
+  Node node = AppendPath(path, parent_node, id);
+  SetPathData(node, path_data);
   return node;
 }
 
-xmlNodePtr Document::DrawPath(const Path &path, xmlNodePtr parent_node,
-                              const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "path");
+Node Document::AppendPath(const Path &path, Node parent_node,
+                          const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "path");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
   }
 
-  std::stringstream path_ss;
-  for (const PathCommand &cmd : path.commands) {
-    path_ss << cmd.ToString() << " ";
-  }
-
+  std::string style;
   if (path.fill_transparent == true) {
-    SetAttribute(node, "fill", "transparent");
+    AppendProperty(style, "fill", "none");
   } else {
-    SetAttribute(node, "fill", ColorToString(path.fill_color));
-    SetAttribute(node, "fill-opacity", std::to_string(path.fill_opacity));
+    AppendProperty(style, "fill", ColorToString(path.fill_color));
+    AppendProperty(style, "fill-opacity", FormatNumber(path.fill_opacity));
+  }
+  AppendProperty(style, "stroke", ColorToString(path.stroke_color));
+  AppendProperty(style, "stroke-width", FormatNumber(path.stroke_width));
+  SetAttribute(node, "class", StyleClass(style));
+
+  return node;
+}
+
+Node Document::DrawUse(const Use &use, Node parent_node,
+                       const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "use");
+
+  if (!id.empty()) {
+    SetAttribute(node, "id", id);
+  }
+
+  SetAttribute(node, "href", use.href);
+  SetAttribute(node, "x", FormatNumber(use.x));
+  SetAttribute(node, "y", FormatNumber(use.y));
+
+  return node;
+}
+
+Node Document::DrawImage(const Image &image, Node parent_node,
+                         const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "image");
+
+  if (!id.empty()) {
+    SetAttribute(node, "id", id);
   }
 
-  SetAttribute(node, "stroke", ColorToString(path.stroke_color));
-  SetAttribute(node, "stroke-width", std::to_string(path.stroke_width));
-  SetAttribute(node, "d", path_ss.str());
+  SetAttribute(node, "x", FormatNumber(image.x));
+  SetAttribute(node, "y", FormatNumber(image.y));
+  SetAttribute(node, "width", FormatNumber(image.width));
+  SetAttribute(node, "height", FormatNumber(image.height));
+  SetAttribute(node, "preserveAspectRatio", "none");
+  SetAttribute(node, "image-rendering", "optimizeSpeed");
+  SetAttribute(node, "href", image.href);
 
   return node;
 }
 
-xmlNodePtr Document::DrawText(const Text &text, xmlNodePtr parent_node,
-                              const std::string &id) {
-  xmlNodePtr parent = parent_node == nullptr ? m_root : parent_node;
-  auto *node = AppendNode(parent, "text");
+Node Document::DrawText(const Text &text, Node parent_node,
+                        const std::string &id) {
+  Node parent = parent_node.IsNull() ? Root() : parent_node;
+  Node node = AppendNode(parent, "text");
 
   if (!id.empty()) {
     SetAttribute(node, "id", id);
   }
 
-  xmlNodeSetContent(node, xchar(text.text.c_str()));
-  SetAttribute(node, "x", std::to_string(text.x));
-  SetAttribute(node, "y", std::to_string(text.y));
-  SetAttribute(node, "font-size", std::to_string(text.font_size));
+  SetContent(node, text.text);
+  SetAttribute(node, "x", FormatNumber(text.x));
+  SetAttribute(node, "y", FormatNumber(text.y));
+  SetAttribute(node, "font-size", FormatNumber(text.font_size));
 
   if (!text.font_family.empty()) {
     SetAttribute(node, "font-family", text.font_family);
@@ -278,5 +878,181 @@ xmlNodePtr Document::DrawText(const Text &text, xmlNodePtr parent_node,
   return node;
 }
 
+void Document::SetPathData(Node node, const Path &path) {
+  // Path data contains no characters that need escaping, so the streaming
+  // backend serializes it in place.
+  const bool is_open_stream_tag =
+      (node.document == this) && !m_stream_open.empty() &&
+      (m_stream_open.back().id == node.id) && m_stream_open.back().tag_open;
+  if (is_open_stream_tag) {
+    m_stream += " d=\"";
+    path.AppendData(m_stream, m_precision);
+    m_stream += '"';
+    return;
+  }
+
+  std::string path_data;
+  path.AppendData(path_data, m_precision);
+  SetAttribute(node, "d", path_data);
+}
+
+void Document::SetPathData(Node node, const std::string &path_data) {
+  const bool is_open_stream_tag =
+      (node.document == this) && !m_stream_open.empty() &&
+      (m_stream_open.back().id == node.id) && m_stream_open.back().tag_open;
+  if (is_open_stream_tag) {
+    m_stream += " d=\"";
+    m_stream += path_data;
+    m_stream += '"';
+    return;
+  }
+
+  SetAttribute(node, "d", path_data);
+}
+
+Node Document::StreamOpen(Node parent, const std::string &name) {
+  // Close the elements opened after the parent. If the parent is no longer
+  // open, the element is appended to the root.
+  std::size_t depth = 0;
+  for (std::size_t i = m_stream_open.size(); i > 0; --i) {
+    if (m_stream_open[i - 1].id == parent.id) {
+      depth = i;
+      break;
+    }
+  }
+  while (m_stream_open.size() > depth) {
+    StreamClose();
+  }
+
+  if (!m_stream_open.empty() && m_stream_open.back().tag_open) {
+    StreamElement &parent_element = m_stream_open.back();
+    parent_element.tag_open = false;
+    m_stream += '>';
+    AppendEscaped(m_stream, parent_element.content);
+    StreamLineBreak(m_stream);
+  }
+
+  StreamIndent(m_stream, m_stream_open.size() + 1);
+  const std::size_t tag_offset = m_stream.size();
+  m_stream += '<';
+  m_stream += name;
+
+  const std::size_t id = m_stream_next_id++;
+  m_stream_open.push_back(StreamElement{id, name, tag_offset, true, {}});
+  return Node{this, id};
+}
+
+void Document::StreamClose() {
+  const StreamElement &element = m_stream_open.back();
+
+  if (element.tag_open && element.content.empty()) {
+    m_stream += "/>";
+  } else if (element.tag_open) {
+    m_stream += '>';
+    AppendEscaped(m_stream, element.content);
+    m_stream += "</";
+    m_stream += element.name;
+    m_stream += '>';
+  } else {
+    StreamIndent(m_stream, m_stream_open.size());
+    m_stream += "</";
+    m_stream += element.name;
+    m_stream += '>';
+  }
+  StreamLineBreak(m_stream);
+
+  m_stream_open.pop_back();
+}
+
+void Document::StreamSetAttribute(std::size_t id, const std::string &name,
+                                  const std::string &value) {
+  if (id == STREAM_ROOT_ID) {
+    AppendAttribute(m_stream_root_attributes, 0, name, value);
+    return;
+  }
+
+  // Attributes can only be added while the start tag is not yet terminated
+  if (m_stream_open.empty() || (m_stream_open.back().id != id) ||
+      !m_stream_open.back().tag_open) {
+    return;
+  }
+
+  AppendAttribute(m_stream, m_stream_open.back().tag_offset, name, value);
+}
+
+void Document::StreamSetContent(std::size_t id, const std::string &content) {
+  if (m_stream_open.empty() || (m_stream_open.back().id != id) ||
+      !m_stream_open.back().tag_open) {
+    return;
+  }
+
+  m_stream_open.back().content = content;
+}
+
+std::string Document::StreamClosingTags() const {
+  std::string tags;
+  for (std::size_t i = m_stream_open.size(); i > 0; --i) {
+    const StreamElement &element = m_stream_open[i - 1];
+
+    if (element.tag_open) {
+      if (element.content.empty()) {
+        tags += "/>";
+        StreamLineBreak(tags);
+        continue;
+      }
+      tags += '>';
+      AppendEscaped(tags, element.content);
+    } else {
+      StreamIndent(tags, i);
+    }
+    tags += "</";
+    tags += element.name;
+    tags += '>';
+    StreamLineBreak(tags);
+  }
+
+  return tags;
+}
+
+void Document::StreamWriteBody(const Writer &writer) const {
+  const auto write = [&writer](std::string_view text) {
+    writer(text.data(), text.size());
+  };
+
+  if (m_layers.empty()) {
+    write(m_stream);
+    write(StreamClosingTags());
+    return;
+  }
+
+  write(m_stream_unlayered);
+  for (std::size_t i = 0; i < m_layers.size(); ++i) {
+    write(m_compact ? "<g>" : "  <g>\n");
+    if (i == m_layer) {
+      write(m_stream);
+      write(StreamClosingTags());
+    } else {
+      write(m_layers[i].stream);
+    }
+    write(m_compact ? "</g>" : "  </g>\n");
+  }
+}
+
+int Document::StreamDepth(std::size_t depth) const {
+  return static_cast<int>(m_layers.empty() ? depth : depth + 1);
+}
+
+void Document::StreamIndent(std::string &out, std::size_t depth) const {
+  if (!m_compact) {
+    out.append(2 * static_cast<std::size_t>(StreamDepth(depth)), ' ');
+  }
+}
+
+void Document::StreamLineBreak(std::string &out) const {
+  if (!m_compact) {
+    out += '\n';
+  }
+}
+
 } // namespace svg
 } // namespace plotcpp
@@ -0,0 +1,143 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transform.hpp"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "DataArray.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define PLOTCPP_AVX2_DISPATCH
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace plotcpp {
+namespace transform {
+
+// The kernels evaluate the map with the same operations as the scalar code:
+// products and sums are not fused, so that the results are identical.
+
+/** Scalar map for the values left after the vector loop */
+template <typename T>
+static void ScalarApply(const Affine &affine, const T *values,
+                        std::size_t size, float *out) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = Apply(affine, static_cast<Real>(values[i]));
+  }
+}
+
+#ifdef PLOTCPP_AVX2_DISPATCH
+/** Map 4 values converted to double */
+__attribute__((target("avx2"))) static inline __m128
+Avx2Map(__m256d value, __m256d origin, __m256d scale, __m256d base,
+        __m128 offset) {
+  const __m256d mapped =
+      _mm256_add_pd(base, _mm256_mul_pd(scale, _mm256_sub_pd(value, origin)));
+  return _mm_add_ps(_mm256_cvtpd_ps(mapped), offset);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) static void
+Avx2Apply(const Affine &affine, const T *values, std::size_t size, float *out) {
+  constexpr std::size_t LANES = 4;
+  const __m256d origin = _mm256_set1_pd(affine.origin);
+  const __m256d scale = _mm256_set1_pd(affine.scale);
+  const __m256d base = _mm256_set1_pd(affine.base);
+  const __m128 offset = _mm_set1_ps(affine.offset);
+
+  std::size_t i = 0;
+  for (; i + LANES <= size; i += LANES) {
+    __m256d value;
+    if constexpr (std::is_same_v<T, double>) {
+      value = _mm256_loadu_pd(&values[i]);
+    } else {
+      value = _mm256_cvtps_pd(_mm_loadu_ps(&values[i]));
+    }
+    _mm_storeu_ps(&out[i], Avx2Map(value, origin, scale, base, offset));
+  }
+  ScalarApply(affine, &values[i], size - i, &out[i]);
+}
+
+static bool HasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+template <typename T>
+static void NeonApply(const Affine &affine, const T *values, std::size_t size,
+                      float *out) {
+  constexpr std::size_t LANES = 2;
+  const float64x2_t origin = vdupq_n_f64(affine.origin);
+  const float64x2_t scale = vdupq_n_f64(affine.scale);
+  const float64x2_t base = vdupq_n_f64(affine.base);
+  const float32x2_t offset = vdup_n_f32(affine.offset);
+
+  std::size_t i = 0;
+  for (; i + LANES <= size; i += LANES) {
+    float64x2_t value;
+    if constexpr (std::is_same_v<T, double>) {
+      value = vld1q_f64(&values[i]);
+    } else {
+      value = vcvt_f64_f32(vld1_f32(&values[i]));
+    }
+    const float64x2_t mapped =
+        vaddq_f64(base, vmulq_f64(scale, vsubq_f64(value, origin)));
+    vst1_f32(&out[i], vadd_f32(vcvt_f32_f64(mapped), offset));
+  }
+  ScalarApply(affine, &values[i], size - i, &out[i]);
+}
+#endif
+
+/** Map with a vector kernel if the CPU has one */
+template <typename T>
+static void DispatchApply(const Affine &affine, std::span<const T> values,
+                          float *out) {
+#ifdef PLOTCPP_AVX2_DISPATCH
+  if (HasAvx2()) {
+    Avx2Apply(affine, values.data(), values.size(), out);
+    return;
+  }
+  ScalarApply(affine, values.data(), values.size(), out);
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  NeonApply(affine, values.data(), values.size(), out);
+#else
+  ScalarApply(affine, values.data(), values.size(), out);
+#endif
+}
+
+void Apply(const Affine &affine, std::span<const double> values, float *out) {
+  DispatchApply(affine, values, out);
+}
+
+void Apply(const Affine &affine, std::span<const float> values, float *out) {
+  DispatchApply(affine, values, out);
+}
+
+void Apply(const Affine &affine, const DataArray &values, std::size_t first,
+           std::size_t count, float *out) {
+  values.Visit(
+      [&](auto view) { Apply(affine, view.subspan(first, count), out); });
+}
+
+} // namespace transform
+} // namespace plotcpp
@@ -0,0 +1,689 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "GroupFigure.hpp"
+#include "Plot2D.hpp"
+
+namespace plotcpp {
+
+using Layer = Figure::Layer;
+
+static const std::vector<Real> X{0, 1, 2};
+static const std::vector<Real> Y0{0, 1, 0};
+static const std::vector<Real> Y1{1, 0, 1};
+
+/** Returns the number of occurrences of a pattern in a text */
+static std::size_t Count(const std::string &text, const std::string &pattern) {
+  std::size_t count = 0;
+  for (auto pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(Plot2DTest, RebuildInvalidatedLayers) {
+  for (const auto backend :
+       {svg::Document::Backend::DOM, svg::Document::Backend::STREAM}) {
+    Plot2D plot;
+    plot.SetSVGBackend(backend);
+    plot.SetYRange(-1, 1);
+    plot.Plot(X, Y0);
+    plot.Build();
+    EXPECT_EQ(plot.GetRebuiltLayers().size(), Figure::NUM_LAYERS);
+
+    plot.Build();
+    EXPECT_TRUE(plot.GetRebuiltLayers().empty());
+
+    plot.SetTitle("Title");
+    plot.Build();
+    EXPECT_EQ(plot.GetRebuiltLayers(), std::vector<Layer>{Layer::TITLE});
+
+    plot.SetHold(false);
+    plot.Plot(X, Y1);
+    plot.Build();
+    EXPECT_EQ(plot.GetRebuiltLayers(),
+              (std::vector<Layer>{Layer::DATA, Layer::LEGEND}));
+
+    // The automatic x range changes with the data
+    plot.Plot(std::vector<Real>{0, 1, 2, 3}, std::vector<Real>{1, 0, 1, 0});
+    plot.Build();
+    EXPECT_EQ(plot.GetRebuiltLayers(),
+              (std::vector<Layer>{Layer::FRAME, Layer::DATA, Layer::LEGEND}));
+
+    plot.SetSize(300, 200);
+    plot.Build();
+    EXPECT_EQ(plot.GetRebuiltLayers().size(), Figure::NUM_LAYERS);
+  }
+}
+
+TEST(Plot2DTest, RebuildMatchesFullBuild) {
+  for (const auto backend :
+       {svg::Document::Backend::DOM, svg::Document::Backend::STREAM}) {
+    Plot2D incremental;
+    incremental.SetSVGBackend(backend);
+    incremental.SetYRange(-2, 2);
+    incremental.SetHold(false);
+    incremental.Plot(X, Y0, Color{0, 0, 255});
+    incremental.Build();
+    incremental.Plot(X, Y1, Color{0, 0, 255});
+    incremental.Build();
+
+    Plot2D full;
+    full.SetSVGBackend(backend);
+    full.SetYRange(-2, 2);
+    full.Plot(X, Y1, Color{0, 0, 255});
+    full.Build();
+
+    EXPECT_EQ(incremental.GetSVGText(), full.GetSVGText());
+  }
+}
+
+TEST(Plot2DTest, SimplifyDenseSeries) {
+  std::vector<Real> x(10000);
+  std::vector<Real> y(10000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 1000);
+  }
+
+  Plot2D plot;
+  plot.Plot(x, y);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().removed_vertices, 0);
+
+  plot.SetSimplification(Plot2D::Simplification::DOUGLAS_PEUCKER);
+  plot.Build();
+  const std::size_t removed_dp = plot.GetDataStats().removed_vertices;
+  EXPECT_GT(removed_dp, 0);
+  EXPECT_LT(removed_dp, x.size() - 1);
+  EXPECT_EQ(plot.GetRebuiltLayers(), std::vector<Layer>{Layer::DATA});
+
+  plot.SetSimplification(0, Plot2D::Simplification::VISVALINGAM);
+  plot.Build();
+  EXPECT_GT(plot.GetDataStats().removed_vertices, 0);
+}
+
+TEST(Plot2DTest, DecimateDenseSeries) {
+  std::vector<Real> x(100000);
+  std::vector<Real> y(100000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = static_cast<Real>(i % 7);
+  }
+
+  Plot2D plot;
+  plot.SetDecimation(Plot2D::Decimation::NONE);
+  plot.Plot(x, y);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().decimated_vertices, 0);
+
+  plot.SetDecimation(Plot2D::Decimation::M4);
+  plot.Build();
+  EXPECT_GT(plot.GetDataStats().decimated_vertices, x.size() / 2);
+
+  // Series below the threshold are not decimated
+  plot.SetDecimation(0, Plot2D::Decimation::M4, 1000.0f);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().decimated_vertices, 0);
+}
+
+TEST(Plot2DTest, DownsampleVisibleWindow) {
+  std::vector<Real> x(10000);
+  std::vector<Real> y(10000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 10);
+  }
+
+  Plot2D plot;
+  plot.SetDecimation(Plot2D::Decimation::NONE);
+  plot.SetDownsampling(500);
+  plot.Plot(x, y);
+  plot.Plot(x, y);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().downsampled_vertices, 2 * (x.size() - 500));
+
+  // Only the visible points and one point at each side are downsampled
+  plot.SetXRange(1000, 1999);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().downsampled_vertices, 2 * (1002 - 500));
+
+  plot.SetDownsampling(0, 0);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().downsampled_vertices, 1002 - 500);
+}
+
+TEST(Plot2DTest, DownsampleBudgetWithGaps) {
+  // 500 polylines of 19 points separated by infinite values
+  std::vector<Real> x(10000);
+  std::vector<Real> y(10000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = (i % 20 == 19) ? std::numeric_limits<Real>::infinity()
+                          : std::sin(static_cast<Real>(i) / 10);
+  }
+  const std::size_t num_finite = x.size() - x.size() / 20;
+
+  for (const std::size_t max_points : {100, 999, 1000, 5000}) {
+    Plot2D plot;
+    plot.SetDecimation(Plot2D::Decimation::NONE);
+    plot.SetDownsampling(max_points);
+    plot.Plot(x, y);
+    plot.Build();
+
+    const std::size_t kept =
+        num_finite - plot.GetDataStats().downsampled_vertices;
+    EXPECT_LE(kept, max_points);
+    EXPECT_GE(kept, max_points - 1);
+  }
+}
+
+TEST(Plot2DTest, MovedAndBorrowedData) {
+  Plot2D copied;
+  copied.Plot(X, Y0, Color{0, 0, 255});
+  copied.Scatter(X, Y1, Color{255, 0, 0});
+  copied.Build();
+
+  std::vector<Real> x0 = X;
+  std::vector<Real> y0 = Y0;
+  Plot2D moved;
+  moved.Plot(std::move(x0), std::move(y0), Color{0, 0, 255});
+  moved.Scatter(std::vector<Real>(X), std::vector<Real>(Y1),
+                Color{255, 0, 0});
+  moved.Build();
+  EXPECT_TRUE(x0.empty());
+  EXPECT_EQ(moved.GetSVGText(), copied.GetSVGText());
+
+  Plot2D borrowed;
+  borrowed.Plot(std::span<const Real>(X), std::span<const Real>(Y0),
+                Color{0, 0, 255});
+  borrowed.Scatter(std::span<const Real>(X), std::span<const Real>(Y1),
+                   Color{255, 0, 0});
+  borrowed.Build();
+  EXPECT_EQ(borrowed.GetSVGText(), copied.GetSVGText());
+}
+
+TEST(Plot2DTest, NativeDataTypes) {
+  const std::vector<float> x_float{0, 1, 2};
+  const std::vector<std::int32_t> y_int{0, 1, 0};
+  const std::vector<std::uint64_t> y_uint{1, 0, 1};
+
+  Plot2D real;
+  real.Plot(X, Y0, Color{0, 0, 255});
+  real.Scatter(X, Y1, Color{255, 0, 0});
+  real.Build();
+
+  Plot2D native;
+  native.Plot(x_float, y_int, Color{0, 0, 255});
+  native.Scatter(std::span<const float>(x_float),
+                 std::span<const std::uint64_t>(y_uint), Color{255, 0, 0});
+  native.Build();
+  EXPECT_EQ(native.GetSVGText(), real.GetSVGText());
+}
+
+TEST(Plot2DTest, AppendToStream) {
+  std::vector<Real> x(100);
+  std::vector<Real> y(100);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 10);
+  }
+
+  Plot2D streamed;
+  const auto series = streamed.PlotStream(50, Color{0, 0, 255});
+  streamed.Append(series, std::span<const Real>(x).first(60),
+                  std::span<const Real>(y).first(60));
+  streamed.Build();
+  for (std::size_t i = 60; i < x.size(); ++i) {
+    streamed.Append(series, x[i], y[i]);
+  }
+  streamed.Build();
+  EXPECT_EQ(streamed.GetRebuiltLayers(),
+            (std::vector<Layer>{Layer::FRAME, Layer::DATA, Layer::LEGEND}));
+
+  // Only the last points are kept
+  Plot2D window;
+  window.Plot(std::vector<Real>(x.begin() + 50, x.end()),
+              std::vector<Real>(y.begin() + 50, y.end()), Color{0, 0, 255});
+  window.Build();
+  EXPECT_EQ(streamed.GetSVGText(), window.GetSVGText());
+
+  // Empty handles do not select a series
+  window.Append({}, 0, 0);
+  window.Build();
+  EXPECT_TRUE(window.GetRebuiltLayers().empty());
+
+  // Handles of replaced series do not select the new series
+  streamed.SetHold(false);
+  const auto replacement = streamed.PlotStream(50, Color{0, 0, 255});
+  streamed.Append(replacement, std::span<const Real>(x).subspan(50),
+                  std::span<const Real>(y).subspan(50));
+  streamed.Build();
+  streamed.Append(series, 1000, 1000);
+  streamed.Build();
+  EXPECT_TRUE(streamed.GetRebuiltLayers().empty());
+  EXPECT_EQ(streamed.GetSVGText(), window.GetSVGText());
+}
+
+TEST(Plot2DTest, OutputIndependentOfThreads) {
+  std::vector<Real> x(1000);
+  std::vector<std::vector<Real>> y(16, std::vector<Real>(1000));
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    for (std::size_t j = 0; j < y.size(); ++j) {
+      y[j][i] = std::sin(static_cast<Real>(i * (j + 1)) / 100);
+    }
+  }
+  std::vector<std::string> labels(x.size(), "");
+
+  std::vector<std::string> serial_text;
+  for (const std::size_t num_threads : {1, 0, 3}) {
+    Plot2D numeric;
+    numeric.SetNumThreads(num_threads);
+    Plot2D categorical;
+    categorical.SetNumThreads(num_threads);
+    for (std::size_t j = 0; j < y.size(); ++j) {
+      numeric.Plot(x, y[j]);
+      categorical.Plot(labels, y[j]);
+    }
+    numeric.Scatter(x, y[0]);
+    numeric.Build();
+    categorical.Build();
+
+    if (serial_text.empty()) {
+      serial_text = {numeric.GetSVGText(), categorical.GetSVGText()};
+    } else {
+      EXPECT_EQ(numeric.GetSVGText(), serial_text[0]);
+      EXPECT_EQ(categorical.GetSVGText(), serial_text[1]);
+    }
+  }
+}
+
+TEST(Plot2DTest, CullGeometryOutsideZoom) {
+  std::vector<Real> x(100000);
+  std::vector<Real> y(100000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 100);
+  }
+
+  Plot2D full;
+  full.SetDecimation(Plot2D::Decimation::NONE);
+  full.Plot(x, y);
+  full.Scatter(x, y);
+  full.Build();
+  EXPECT_EQ(full.GetDataStats().culled_vertices, 0);
+
+  Plot2D zoomed;
+  zoomed.SetDecimation(Plot2D::Decimation::NONE);
+  zoomed.SetXRange(50000, 51000);
+  zoomed.SetYRange(-2, 2);
+  zoomed.Plot(x, y);
+  zoomed.Scatter(x, y);
+  zoomed.Build();
+  EXPECT_GT(zoomed.GetDataStats().culled_vertices, 2 * 98000);
+  EXPECT_LT(zoomed.GetSVGText().size(), full.GetSVGText().size() / 50);
+}
+
+TEST(Plot2DTest, NonFiniteValuesSplitLines) {
+  std::vector<Real> x(100000);
+  std::vector<Real> y(100000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 100);
+  }
+  x[500] = std::numeric_limits<Real>::quiet_NaN();
+  y[70000] = std::numeric_limits<Real>::quiet_NaN();
+  y[80000] = std::numeric_limits<Real>::infinity();
+
+  // Dense enough to be decimated, both clipped and not clipped
+  Plot2D plot;
+  plot.Plot(x, y);
+  plot.Plot(x, y, 2, "4 2");
+  plot.Build();
+  EXPECT_GT(plot.GetDataStats().decimated_vertices, 0);
+
+  const std::string text = plot.GetSVGText();
+  EXPECT_EQ(text.find("nan"), std::string::npos);
+  EXPECT_EQ(text.find("inf"), std::string::npos);
+}
+
+TEST(Plot2DTest, SortedSeriesWindow) {
+  std::vector<Real> x(100000);
+  std::vector<Real> y(100000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i);
+    y[i] = std::sin(static_cast<Real>(i) / 100);
+  }
+
+  // Only the visible points and one point at each side are drawn
+  Plot2D zoomed;
+  zoomed.SetXRange(2000.5, 2100.5);
+  zoomed.SetYRange(-2, 2);
+  zoomed.Plot(x, y, Color{0, 0, 255});
+  zoomed.Build();
+  EXPECT_EQ(zoomed.GetDataStats().culled_vertices, x.size() - 102);
+
+  Plot2D visible;
+  visible.SetXRange(2000.5, 2100.5);
+  visible.SetYRange(-2, 2);
+  visible.Plot(std::span<const Real>(x).subspan(2000, 102),
+               std::span<const Real>(y).subspan(2000, 102), Color{0, 0, 255});
+  visible.Build();
+  EXPECT_EQ(zoomed.GetSVGText(), visible.GetSVGText());
+}
+
+TEST(Plot2DTest, DensityScatter) {
+  std::vector<Real> x(200000);
+  std::vector<Real> y(200000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = std::sin(static_cast<Real>(i));
+    y[i] = std::cos(static_cast<Real>(i) * 1.5);
+  }
+
+  Plot2D plot;
+  plot.SetScatterMode(Plot2D::ScatterMode::DENSITY);
+  plot.Scatter(x, y);
+  plot.Build();
+
+  const std::string text = plot.GetSVGText();
+  EXPECT_EQ(text.find("<circle"), std::string::npos);
+  EXPECT_NE(text.find("<image"), std::string::npos);
+  EXPECT_NE(text.find("data:image/png;base64,"), std::string::npos);
+}
+
+TEST(Plot2DTest, SkipOverdrawnMarkers) {
+  // Many markers on the same 10 x 10 lattice of points
+  std::vector<Real> x(10000);
+  std::vector<Real> y(10000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i % 10);
+    y[i] = static_cast<Real>((i / 10) % 10);
+  }
+
+  Plot2D plot;
+  plot.Scatter(x, y);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().overdrawn_markers, 0);
+
+  plot.SetOverdrawElimination(true);
+  plot.Build();
+  EXPECT_EQ(plot.GetDataStats().overdrawn_markers, x.size() - 100);
+
+  std::size_t num_circles = 0;
+  const std::string text = plot.GetSVGText();
+  for (auto pos = text.find("<circle"); pos != std::string::npos;
+       pos = text.find("<circle", pos + 1)) {
+    ++num_circles;
+  }
+  EXPECT_EQ(num_circles, 100);
+}
+
+TEST(Plot2DTest, PlotFunctionOverInterval) {
+  std::vector<Real> evaluations;
+  auto function = [&](Real x) {
+    evaluations.push_back(x);
+    return std::sin(2 * M_PI * x) * std::exp(-x);
+  };
+
+  Plot2D plot;
+  plot.Plot(ranges::Interval<Real>{0, 10}, function);
+  EXPECT_TRUE(evaluations.empty());
+  plot.Build();
+  const std::size_t num_evaluations = evaluations.size();
+  // Hundreds of evaluations for a 480 px wide frame, instead of the 10000 of
+  // a fixed 0.001 step
+  EXPECT_GT(num_evaluations, 100);
+  EXPECT_LT(num_evaluations, 500);
+  const std::string text = plot.GetSVGText();
+  EXPECT_NE(text.find("<path"), std::string::npos);
+
+  // Empty intervals add no series
+  plot.Plot(ranges::Interval<Real>{1, 1}, function);
+  plot.Build();
+  EXPECT_EQ(plot.GetSVGText(), text);
+  EXPECT_EQ(evaluations.size(), num_evaluations);
+
+  // Zooming samples the visible part of the interval again
+  evaluations.clear();
+  plot.SetXRange(2, 3);
+  plot.Build();
+  EXPECT_GT(evaluations.size(), 0);
+  EXPECT_TRUE(std::all_of(evaluations.begin(), evaluations.end(),
+                          [](Real x) { return (x >= 2) && (x <= 3); }));
+
+  // Resizing samples at the new resolution
+  evaluations.clear();
+  plot.SetXRange(0, 10);
+  plot.SetSize(1200, 900);
+  plot.Build();
+  EXPECT_GT(evaluations.size(), num_evaluations);
+}
+
+TEST(Plot2DTest, PlotFunctionRefinesDiscontinuities) {
+  // Distance between the samples before and after x
+  const auto gap_at = [](std::vector<Real> evaluations, Real x) {
+    std::sort(evaluations.begin(), evaluations.end());
+    const auto after =
+        std::lower_bound(evaluations.begin(), evaluations.end(), x);
+    return *after - *(after - 1);
+  };
+
+  std::vector<Real> step_evaluations;
+  auto step = [&](Real x) {
+    step_evaluations.push_back(x);
+    return (x < 0.3) ? 0.0 : 1.0;
+  };
+
+  std::vector<Real> pole_evaluations;
+  auto pole = [&](Real x) {
+    pole_evaluations.push_back(x);
+    return 1 / x;
+  };
+
+  // The frame is 480 px wide. Samples are refined to less than a px at the
+  // discontinuities, and stay 4 px apart where the functions are flat.
+  Plot2D plot;
+  plot.Plot(ranges::Interval<Real>{0, 1}, step);
+  plot.Build();
+  EXPECT_LT(step_evaluations.size(), 200);
+  EXPECT_LT(gap_at(step_evaluations, 0.3), 1.0 / 480);
+  EXPECT_GE(gap_at(step_evaluations, 0.7), 3.0 / 480);
+
+  Plot2D pole_plot;
+  pole_plot.Plot(ranges::Interval<Real>{-1, 1}, pole);
+  pole_plot.Build();
+  EXPECT_LT(pole_evaluations.size(), 500);
+  EXPECT_LT(gap_at(pole_evaluations, 0), 2.0 / 480);
+  EXPECT_GE(gap_at(pole_evaluations, 0.9), 2 * 3.0 / 480);
+}
+
+TEST(Plot2DTest, GeneratorFollowsXRange) {
+  std::atomic<std::size_t> num_evaluations = 0;
+  auto generator = [&](Real x) {
+    ++num_evaluations;
+    return 2 * x;
+  };
+
+  std::vector<Real> x{0, 10};
+  std::vector<Real> y{0, 1};
+  Plot2D plot;
+  plot.SetSize(600, 450);
+  plot.SetNumThreads(4);
+  plot.Plot(x, y);
+  plot.PlotGenerator(generator);
+  plot.Build();
+
+  // One sample per px of the frame, kept between builds
+  const std::size_t num_samples = num_evaluations;
+  EXPECT_GT(num_samples, 100);
+  EXPECT_LT(num_samples, 600);
+  const std::string text = plot.GetSVGText();
+  plot.Build();
+  EXPECT_EQ(num_evaluations, num_samples);
+  EXPECT_EQ(plot.GetSVGText(), text);
+
+  // Zooming samples the new range again
+  plot.SetXRange(2, 4);
+  plot.Build();
+  EXPECT_EQ(num_evaluations, 2 * num_samples);
+  EXPECT_NE(plot.GetSVGText(), text);
+
+  // Resizing samples at the new width
+  plot.SetSize(1200, 450);
+  plot.Build();
+  EXPECT_GT(num_evaluations, 4 * num_samples - 4);
+}
+
+TEST(Plot2DTest, SinglePrecisionStorage) {
+  std::vector<Real> x(1000);
+  std::vector<Real> y(1000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<Real>(i) / 7;
+    y[i] = std::sin(x[i]);
+  }
+  const std::vector<float> x_float(x.begin(), x.end());
+  const std::vector<float> y_float(y.begin(), y.end());
+
+  Plot2D native;
+  native.Plot(x_float, y_float, Color{0, 0, 255});
+  native.Build();
+
+  // Series plotted before and after the precision is set are converted
+  Plot2D converted;
+  converted.Plot(x, y, Color{0, 0, 255});
+  converted.SetStoragePrecision(Plot2D::StoragePrecision::FLOAT32);
+  converted.Build();
+  EXPECT_EQ(converted.GetSVGText(), native.GetSVGText());
+
+  converted.SetHold(false);
+  converted.Plot(x, y, Color{0, 0, 255});
+  converted.Build();
+  EXPECT_EQ(converted.GetSVGText(), native.GetSVGText());
+
+  // Borrowed values are not copied
+  Plot2D borrowed;
+  borrowed.SetStoragePrecision(Plot2D::StoragePrecision::FLOAT32);
+  borrowed.Plot(std::span<const Real>(x), std::span<const Real>(y),
+                Color{0, 0, 255});
+  borrowed.Build();
+
+  Plot2D full;
+  full.Plot(x, y, Color{0, 0, 255});
+  full.Build();
+  EXPECT_EQ(borrowed.GetSVGText(), full.GetSVGText());
+}
+
+TEST(Plot2DTest, ScatterModes) {
+  Plot2D symbols;
+  symbols.SetScatterMode(Plot2D::ScatterMode::SYMBOLS);
+  symbols.Scatter(X, Y0, Color{255, 0, 0}, 3);
+  symbols.Scatter(X, Y1, Color{0, 0, 255}, 3);
+  symbols.Build();
+
+  // One marker definition per series and one <use> per point, in a group per
+  // series inside the clipped data layer
+  std::string text = symbols.GetSVGText();
+  EXPECT_EQ(Count(text, "<circle"), 2);
+  EXPECT_EQ(Count(text, "<use"), 2 * X.size());
+  EXPECT_EQ(Count(text, "<g>"), Count(text, "<g/>") + 2);
+  EXPECT_EQ(Count(text, "clip-path=\""), 1);
+  const std::size_t red_group = text.find("href=\"#marker-ff0000-3\"");
+  const std::size_t blue_group = text.find("href=\"#marker-0000ff-3\"");
+  ASSERT_NE(red_group, std::string::npos);
+  ASSERT_NE(blue_group, std::string::npos);
+  EXPECT_NE(text.find("<g>", red_group), std::string::npos);
+  EXPECT_LT(text.find("<g>", red_group), blue_group);
+
+  Plot2D path;
+  path.SetScatterMode(Plot2D::ScatterMode::PATH);
+  path.Scatter(X, Y0, Color{255, 0, 0}, 3);
+  path.Scatter(X, Y1, Color{0, 0, 255}, 3);
+  path.Build();
+
+  // One path per series with a zero-length segment per point
+  text = path.GetSVGText();
+  EXPECT_EQ(Count(text, "<circle"), 0);
+  EXPECT_EQ(Count(text, "<use"), 0);
+  EXPECT_EQ(Count(text, "<path"), 2);
+  EXPECT_EQ(Count(text, "h0"), 2 * X.size());
+  EXPECT_EQ(Count(text, "stroke-linecap=\"round\""), 2);
+  EXPECT_EQ(Count(text, "clip-path=\""), 1);
+}
+
+TEST(Plot2DTest, GroupedScatterMarkers) {
+  Plot2D red;
+  red.SetScatterMode(Plot2D::ScatterMode::SYMBOLS);
+  red.Scatter(X, Y0, Color{255, 0, 0}, 3);
+
+  Plot2D blue;
+  blue.SetScatterMode(Plot2D::ScatterMode::SYMBOLS);
+  blue.Scatter(X, Y1, Color{0, 0, 255}, 2);
+
+  GroupFigure<1, 2> group;
+  group.Subplot(&red, 0, 0);
+  group.Subplot(&blue, 0, 1);
+  group.Build();
+
+  // Each subplot references its own marker
+  const std::string text = group.GetSVGText();
+  EXPECT_EQ(Count(text, "id=\"marker-ff0000-3\""), 1);
+  EXPECT_EQ(Count(text, "id=\"marker-0000ff-2\""), 1);
+  EXPECT_EQ(Count(text, "href=\"#marker-ff0000-3\""), X.size());
+  EXPECT_EQ(Count(text, "href=\"#marker-0000ff-2\""), X.size());
+}
+
+TEST(Plot2DTest, WriteSVGToFileDescriptor) {
+  Plot2D plot;
+  plot.Plot(X, Y0);
+  plot.Build();
+
+  std::FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  EXPECT_TRUE(plot.WriteSVG(fileno(file)));
+  std::string text(static_cast<std::size_t>(std::ftell(file)), '\0');
+  std::rewind(file);
+  EXPECT_EQ(std::fread(text.data(), 1, text.size(), file), text.size());
+  std::fclose(file);
+  EXPECT_EQ(text, plot.GetSVGText());
+
+  // Writing to a descriptor that is not open for writing fails
+  const int fd = open("/dev/null", O_RDONLY);
+  ASSERT_GE(fd, 0);
+  EXPECT_FALSE(plot.WriteSVG(fd));
+  EXPECT_EQ(errno, EBADF);
+  close(fd);
+}
+
+} // namespace plotcpp
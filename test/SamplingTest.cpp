@@ -0,0 +1,237 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock-matchers.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "sampling.hpp"
+
+namespace plotcpp {
+
+using ::testing::ElementsAreArray;
+
+TEST(SamplingTest, CollinearPointsAreRemoved) {
+  for (const auto simplify :
+       {sampling::SimplifyDouglasPeucker, sampling::SimplifyVisvalingam}) {
+    std::vector<float> x{0, 1, 2, 3, 4};
+    std::vector<float> y{0, 1, 2, 3, 4};
+    EXPECT_EQ(simplify(x.data(), y.data(), x.size(), 0.25f), 2);
+    EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + 2),
+                ElementsAreArray({0.0f, 4.0f}));
+    EXPECT_THAT(std::vector<float>(y.begin(), y.begin() + 2),
+                ElementsAreArray({0.0f, 4.0f}));
+  }
+}
+
+TEST(SamplingTest, CornersAreKept) {
+  for (const auto simplify :
+       {sampling::SimplifyDouglasPeucker, sampling::SimplifyVisvalingam}) {
+    std::vector<float> x{0, 1, 2, 3, 4, 5, 6};
+    std::vector<float> y{0, 0.1f, 0, 5, 0, -0.1f, 0};
+    const std::size_t kept = simplify(x.data(), y.data(), x.size(), 0.5f);
+    EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + kept),
+                ElementsAreArray({0.0f, 2.0f, 3.0f, 4.0f, 6.0f}));
+    EXPECT_THAT(std::vector<float>(y.begin(), y.begin() + kept),
+                ElementsAreArray({0.0f, 0.0f, 5.0f, 0.0f, 0.0f}));
+  }
+}
+
+TEST(SamplingTest, ShortPolylinesAreKept) {
+  std::vector<float> x{0, 1};
+  std::vector<float> y{0, 1};
+  EXPECT_EQ(sampling::SimplifyDouglasPeucker(x.data(), y.data(), 2, 1.0f), 2);
+  EXPECT_EQ(sampling::SimplifyVisvalingam(x.data(), y.data(), 2, 1.0f), 2);
+  EXPECT_EQ(sampling::SimplifyDouglasPeucker(x.data(), y.data(), 0, 1.0f), 0);
+  EXPECT_EQ(sampling::SimplifyVisvalingam(x.data(), y.data(), 0, 1.0f), 0);
+}
+
+TEST(SamplingTest, DecimateM4KeepsColumnExtrema) {
+  std::vector<float> x{0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 1.5f, 2.1f, 2.2f};
+  std::vector<float> y{1.0f, 3.0f, -2.0f, 5.0f, -2.0f, 0.0f, 4.0f, 1.0f, 2.0f};
+  const std::size_t kept =
+      sampling::DecimateM4(x.data(), y.data(), x.size(), 0.0f, 10.0f);
+  EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + kept),
+              ElementsAreArray({0.1f, 0.3f, 0.4f, 0.6f, 1.5f, 2.1f, 2.2f}));
+  EXPECT_THAT(std::vector<float>(y.begin(), y.begin() + kept),
+              ElementsAreArray({1.0f, -2.0f, 5.0f, 0.0f, 4.0f, 1.0f, 2.0f}));
+}
+
+TEST(SamplingTest, DecimateM4MatchesReference) {
+  std::mt19937 generator(0);
+  std::normal_distribution<float> distribution;
+
+  const std::size_t size = 100003;
+  std::vector<float> x(size);
+  std::vector<float> y(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    x[i] = static_cast<float>(i) / 1000.0f - 5.0f;
+    y[i] = distribution(generator);
+    if (i % 997 == 0) {
+      y[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+  }
+
+  // Scalar reference of the first, minimum, maximum and last points of each
+  // column
+  std::vector<float> expected_x;
+  std::vector<float> expected_y;
+  const auto column_of = [](float value) {
+    return static_cast<int>(std::clamp(value, 0.0f, 50.0f));
+  };
+  for (std::size_t start = 0; start < size;) {
+    std::size_t end = start;
+    std::size_t min_index = start;
+    std::size_t max_index = start;
+    while ((end < size) && (column_of(x[end]) == column_of(x[start]))) {
+      if (y[end] < y[min_index] || std::isnan(y[min_index])) {
+        min_index = end;
+      }
+      if (y[end] > y[max_index] || std::isnan(y[max_index])) {
+        max_index = end;
+      }
+      ++end;
+    }
+    for (const std::size_t i : {start, std::min(min_index, max_index),
+                                std::max(min_index, max_index), end - 1}) {
+      if (expected_x.empty() || (x[i] != expected_x.back())) {
+        expected_x.push_back(x[i]);
+        expected_y.push_back(y[i]);
+      }
+    }
+    start = end;
+  }
+
+  const std::size_t kept =
+      sampling::DecimateM4(x.data(), y.data(), size, 0.0f, 50.0f);
+  ASSERT_EQ(kept, expected_x.size());
+  EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + kept),
+              ElementsAreArray(expected_x));
+  for (std::size_t i = 0; i < kept; ++i) {
+    EXPECT_TRUE((y[i] == expected_y[i]) ||
+                (std::isnan(y[i]) && std::isnan(expected_y[i])));
+  }
+}
+
+TEST(SamplingTest, DownsampleLTTBKeepsBudget) {
+  std::vector<float> x(1000);
+  std::vector<float> y(1000);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i);
+    y[i] = 0.0f;
+  }
+  y[500] = 100.0f;
+
+  const std::size_t kept =
+      sampling::DownsampleLTTB(x.data(), y.data(), x.size(), 50);
+  EXPECT_EQ(kept, 50);
+  EXPECT_EQ(x[0], 0.0f);
+  EXPECT_EQ(x[kept - 1], 999.0f);
+  EXPECT_TRUE(std::is_sorted(x.begin(), x.begin() + kept));
+
+  // The peak forms the largest triangle of its bucket
+  EXPECT_NE(std::find(y.begin(), y.begin() + kept, 100.0f), y.begin() + kept);
+}
+
+TEST(SamplingTest, DownsampleLTTBKeepsShortPolylines) {
+  std::vector<float> x{0, 1, 2};
+  std::vector<float> y{0, 1, 0};
+  EXPECT_EQ(sampling::DownsampleLTTB(x.data(), y.data(), 3, 3), 3);
+  EXPECT_EQ(sampling::DownsampleLTTB(x.data(), y.data(), 3, 0), 2);
+  EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + 2),
+              ElementsAreArray({0.0f, 2.0f}));
+}
+
+TEST(SamplingTest, RemoveOverdrawnKeepsFirstMarkers) {
+  std::vector<float> x{1.1f, 1.2f, 1.6f, 5.0f, 1.15f, 20.0f, 20.0f};
+  std::vector<float> y{1.1f, 1.2f, 1.1f, 5.0f, 1.15f, 1.0f, 1.0f};
+  const std::size_t kept = sampling::RemoveOverdrawn(
+      x.data(), y.data(), x.size(), 0.0f, 0.0f, 10.0f, 10.0f, 2);
+  EXPECT_EQ(kept, 5);
+
+  // Markers outside the grid are always kept
+  EXPECT_THAT(std::vector<float>(x.begin(), x.begin() + kept),
+              ElementsAreArray({1.1f, 1.6f, 5.0f, 20.0f, 20.0f}));
+}
+
+TEST(SamplingTest, SampleAdaptiveRefinesCurves) {
+  std::size_t num_evaluations = 0;
+  auto function = [&](double x) {
+    ++num_evaluations;
+    return std::sin(x);
+  };
+
+  const auto [x, y] =
+      sampling::SampleAdaptive(function, 0.0, 20.0 * M_PI, 600.0f, 400.0f);
+  EXPECT_LT(num_evaluations, 1000);
+  EXPECT_EQ(x.front(), 0.0);
+  EXPECT_EQ(x.back(), 20.0 * M_PI);
+  EXPECT_TRUE(std::is_sorted(x.begin(), x.end()));
+
+  // The polyline is within the tolerance of the curve between samples
+  for (std::size_t i = 1; i < x.size(); ++i) {
+    const double x_mid = (x[i - 1] + x[i]) / 2;
+    const double y_mid = (y[i - 1] + y[i]) / 2;
+    EXPECT_LT(std::abs(std::sin(x_mid) - y_mid) * 200.0,
+              4.0 * sampling::ADAPTIVE_TOLERANCE);
+  }
+
+  // Straight lines keep the initial grid
+  num_evaluations = 0;
+  auto line = [&](double x) {
+    ++num_evaluations;
+    return 2.0 * x;
+  };
+  sampling::SampleAdaptive(line, 0.0, 1.0, 600.0f, 400.0f);
+  EXPECT_LT(num_evaluations, 200);
+}
+
+TEST(SamplingTest, SampleAdaptiveRefinesDiscontinuities) {
+  auto step = [](double x) { return (x < 0.3) ? 0.0 : 1.0; };
+  const auto [x, y] = sampling::SampleAdaptive(step, 0.0, 1.0, 600.0f, 400.0f);
+
+  // The jump is located to the minimum step
+  const auto jump = std::find(y.begin(), y.end(), 1.0) - y.begin();
+  ASSERT_GT(jump, 0);
+  EXPECT_LT((x[jump] - x[jump - 1]) * 600.0, 2 * sampling::ADAPTIVE_MIN_STEP);
+  EXPECT_LT(x[jump - 1], 0.3);
+  EXPECT_GE(x[jump], 0.3);
+
+  // Edges of the domain are refined and undefined stretches are not
+  auto root = [](double x) { return std::sqrt(x); };
+  const auto [root_x, root_y] =
+      sampling::SampleAdaptive(root, -1.0, 1.0, 600.0f, 400.0f);
+  EXPECT_LT(root_x.size(), 600);
+  const auto first_finite =
+      std::find_if(root_y.begin(), root_y.end(),
+                   [](double value) { return std::isfinite(value); }) -
+      root_y.begin();
+  EXPECT_LT(std::abs(root_x[first_finite]) * 300.0,
+            sampling::ADAPTIVE_MIN_STEP);
+
+  EXPECT_TRUE(sampling::SampleAdaptive(root, 1.0, 1.0, 600.0f, 400.0f)
+                  .first.empty());
+}
+
+} // namespace plotcpp
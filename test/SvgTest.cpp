@@ -0,0 +1,157 @@
+/*
+ * plotcpp is a 2D plotting library for modern C++
+ *
+ * Copyright 2022  Javier Lancha Vázquez <javier.lancha@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "svg.hpp"
+
+namespace plotcpp {
+
+TEST(SvgTest, FormatNumberShortest) {
+  EXPECT_EQ(svg::FormatNumber(90.0f), "90");
+  EXPECT_EQ(svg::FormatNumber(0.75f), "0.75");
+  EXPECT_EQ(svg::FormatNumber(-12.5f), "-12.5");
+  EXPECT_EQ(svg::FormatNumber(123.456787f), "123.45679");
+  EXPECT_EQ(svg::FormatNumber(-0.0f), "0");
+}
+
+TEST(SvgTest, FormatNumberFixedPrecision) {
+  EXPECT_EQ(svg::FormatNumber(123.456787f, 0), "123");
+  EXPECT_EQ(svg::FormatNumber(123.456787f, 1), "123.5");
+  EXPECT_EQ(svg::FormatNumber(123.456787f, 3), "123.457");
+  EXPECT_EQ(svg::FormatNumber(45.0f, 2), "45");
+  EXPECT_EQ(svg::FormatNumber(45.1f, 2), "45.1");
+  EXPECT_EQ(svg::FormatNumber(-0.001f, 2), "0");
+  EXPECT_EQ(svg::FormatNumber(1000.0f, 2), "1000");
+}
+
+TEST(SvgTest, PathData) {
+  using Id = svg::PathCommand::Id;
+  const std::vector<float> x{1.0f, 2.5f, 4.0f};
+  const std::vector<float> y{-1.0f, 0.0f, 3.25f};
+
+  svg::Path path;
+  path.AddPolyline(x.data(), y.data(), x.size());
+  path.Add(Id::VERTICAL, {10.0f});
+  path.Add(Id::CLOSE, {});
+
+  std::string data;
+  path.AppendData(data);
+  EXPECT_EQ(data, "M1 -1L2.5 0L4 3.25V10Z");
+
+  data.clear();
+  path.Clear();
+  path.AddPolyline(x.data(), y.data(), 0);
+  path.AppendData(data);
+  EXPECT_EQ(data, "");
+}
+
+TEST(SvgTest, ColorToString) {
+  EXPECT_EQ(svg::ColorToString({0, 128, 255}), "RGB(0, 128, 255)");
+}
+
+TEST(SvgTest, WriteInChunks) {
+  for (const auto backend :
+       {svg::Document::Backend::DOM, svg::Document::Backend::STREAM}) {
+    svg::Document document{backend};
+    document.SetSize(100, 50);
+    document.DrawLine({0, 0, 10, 10});
+    svg::Text text_element;
+    text_element.text = "a & b";
+    text_element.x = 5;
+    text_element.y = 5;
+    document.DrawText(text_element);
+
+    std::string text;
+    std::size_t num_chunks = 0;
+    document.Write([&](const char *data, std::size_t size) {
+      text.append(data, size);
+      ++num_chunks;
+    });
+    EXPECT_EQ(text, document.GetText());
+    EXPECT_GT(num_chunks, 0);
+  }
+}
+
+TEST(SvgTest, Compact) {
+  for (const auto backend :
+       {svg::Document::Backend::DOM, svg::Document::Backend::STREAM}) {
+    svg::Document document{backend};
+    document.SetCompact(true);
+    auto group = document.AddGroup();
+    document.DrawCircle({.cx = 1, .cy = 2, .r = 3}, group);
+
+    const std::string text = document.GetText();
+    EXPECT_NE(text.find("<g><circle cx=\"1\" cy=\"2\" r=\"3\""),
+              std::string::npos);
+    EXPECT_EQ(text.find("\n "), std::string::npos);
+  }
+}
+
+/** Returns the number of non-overlapping occurrences of a pattern */
+static std::size_t CountOccurrences(const std::string &text,
+                                    const std::string &pattern) {
+  std::size_t count = 0;
+  for (std::size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(SvgTest, StyleClasses) {
+  for (const auto backend :
+       {svg::Document::Backend::DOM, svg::Document::Backend::STREAM}) {
+    svg::Document document{backend};
+    document.DrawLine({0, 0, 10, 10, {255, 0, 0}});
+    document.DrawLine({0, 10, 10, 0, {255, 0, 0}});
+    document.DrawLine({0, 5, 10, 5, {0, 0, 255}});
+
+    const std::string text = document.GetText();
+    EXPECT_EQ(CountOccurrences(text, "<style>"), 1);
+    EXPECT_EQ(CountOccurrences(text, "stroke:RGB(255, 0, 0)"), 1);
+    EXPECT_EQ(CountOccurrences(text, "class=\"s0\""), 2);
+    EXPECT_EQ(CountOccurrences(text, "class=\"s1\""), 1);
+    EXPECT_EQ(CountOccurrences(text, "stroke="), 0);
+  }
+}
+
+TEST(SvgTest, StyleClassesOfNestedDocuments) {
+  using Backend = svg::Document::Backend;
+  for (const auto backend : {Backend::DOM, Backend::STREAM}) {
+    for (const auto nested_backend : {Backend::DOM, Backend::STREAM}) {
+      svg::Document nested{nested_backend};
+      nested.DrawLine({0, 0, 10, 10, {0, 0, 255}});
+
+      svg::Document document{backend};
+      document.DrawLine({0, 0, 10, 10, {255, 0, 0}});
+      document.AppendDocument(nested, 0, 0);
+
+      const std::string text = document.GetText();
+      EXPECT_EQ(CountOccurrences(text, "<style>"), 1);
+      EXPECT_EQ(CountOccurrences(text, ".s1{stroke:RGB(0, 0, 255)"), 1);
+      EXPECT_EQ(CountOccurrences(text, "class=\"s0\""), 1);
+      EXPECT_EQ(CountOccurrences(text, "class=\"s1\""), 1);
+    }
+  }
+}
+
+} // namespace plotcpp
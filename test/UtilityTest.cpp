@@ -20,8 +20,24 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+#include "clipping.hpp"
+#include "DataArray.hpp"
+#include "density.hpp"
+#include "png.hpp"
+#include "StreamBuffer.hpp"
+#include "ThreadPool.hpp"
+#include "transform.hpp"
+#include "reduction.hpp"
 #include "utility.hpp"
 
 namespace plotcpp {
@@ -63,4 +79,313 @@ TEST(UtilityTest, BinarySearchInterval) {
   EXPECT_EQ(BinarySearchInterval(6.0f, intervals), (Pair{0, false}));
 }
 
+TEST(UtilityTest, DataArrayOwnership) {
+  const std::vector<Real> values{1, 2, 3};
+
+  DataArray owned(std::vector<Real>{1, 2, 3});
+  DataArray owned_copy = owned;
+  EXPECT_TRUE(owned_copy.IsOwned());
+  EXPECT_NE(owned_copy.data(), owned.data());
+  EXPECT_THAT(owned_copy.ToReal(), ElementsAreArray(values));
+
+  const void *data = owned.data();
+  DataArray owned_moved = std::move(owned);
+  EXPECT_EQ(owned_moved.data(), data);
+
+  DataArray borrowed{std::span<const Real>(values)};
+  DataArray borrowed_copy = borrowed;
+  EXPECT_FALSE(borrowed_copy.IsOwned());
+  EXPECT_EQ(borrowed_copy.data(), values.data());
+  EXPECT_THAT(borrowed_copy.ToReal(), ElementsAreArray(values));
+}
+
+TEST(UtilityTest, DataArrayNativeTypes) {
+  const std::vector<std::int32_t> values{-1, 2, 3};
+  DataArray borrowed{std::span<const std::int32_t>(values)};
+  EXPECT_EQ(borrowed.data(), values.data());
+  EXPECT_THAT(borrowed.ToReal(), ElementsAreArray({-1.0, 2.0, 3.0}));
+
+  DataArray owned{std::vector<std::uint64_t>{1, 2, 3}};
+  EXPECT_TRUE(owned.Visit([](auto view) {
+    return std::is_same_v<decltype(view), std::span<const std::uint64_t>>;
+  }));
+  EXPECT_THAT(owned.ToReal(), ElementsAreArray({1.0, 2.0, 3.0}));
+}
+
+TEST(UtilityTest, FiniteRangeSkipsNonFiniteValues) {
+  constexpr Real inf = std::numeric_limits<Real>::infinity();
+  constexpr Real nan = std::numeric_limits<Real>::quiet_NaN();
+
+  // Long enough for the vector lanes and a scalar tail
+  std::vector<Real> values(103, 0.5);
+  values[3] = nan;
+  values[10] = -inf;
+  values[17] = inf;
+  values[40] = -2.0;
+  values[101] = 7.0;
+  EXPECT_EQ(reduction::FiniteRange(values), (std::pair<Real, Real>{-2.0, 7.0}));
+
+  std::vector<float> floats(values.begin(), values.end());
+  floats[0] = nan;
+  EXPECT_EQ(reduction::FiniteRange(DataArray(std::move(floats))),
+            (std::pair<Real, Real>{-2.0, 7.0}));
+
+  const std::vector<Real> non_finite{nan, inf, -inf, nan, nan};
+  EXPECT_EQ(reduction::FiniteRange(non_finite),
+            (std::pair<Real, Real>{std::numeric_limits<Real>::max(),
+                                   std::numeric_limits<Real>::lowest()}));
+
+  EXPECT_EQ(
+      reduction::FiniteRange(DataArray(std::vector<std::int16_t>{3, -4, 5})),
+      (std::pair<Real, Real>{-4.0, 5.0}));
+}
+
+TEST(UtilityTest, StreamBufferSlidingWindow) {
+  constexpr Real nan = std::numeric_limits<Real>::quiet_NaN();
+
+  StreamBuffer stream(3);
+  EXPECT_EQ(stream.Size(), 0);
+  EXPECT_EQ(stream.YRange(),
+            (std::pair<Real, Real>{std::numeric_limits<Real>::max(),
+                                   std::numeric_limits<Real>::lowest()}));
+
+  const std::vector<Real> x{0, 1, 2, 3};
+  const std::vector<Real> y{5, -1, nan, 2};
+  stream.Append(x, y);
+  EXPECT_EQ(stream.Size(), 3);
+  EXPECT_THAT(stream.X(), ::testing::ElementsAre(1, 2, 3));
+  EXPECT_EQ(stream.XRange(), (std::pair<Real, Real>{1, 3}));
+  EXPECT_EQ(stream.YRange(), (std::pair<Real, Real>{-1, 2}));
+
+  // The minimum leaves the window
+  stream.Append(4, 1);
+  stream.Append(5, 0);
+  EXPECT_THAT(stream.X(), ::testing::ElementsAre(3, 4, 5));
+  EXPECT_THAT(stream.Y(), ::testing::ElementsAre(2, 1, 0));
+  EXPECT_EQ(stream.YRange(), (std::pair<Real, Real>{0, 2}));
+
+  // Sequences of different length are ignored
+  stream.Append(x, std::vector<Real>{1});
+  EXPECT_THAT(stream.X(), ::testing::ElementsAre(3, 4, 5));
+}
+
+TEST(UtilityTest, ThreadPoolParallelFor) {
+  for (const std::size_t num_threads : {1, 4}) {
+    ThreadPool pool(num_threads);
+    EXPECT_EQ(pool.NumThreads(), num_threads);
+
+    // Every iteration runs exactly once, also with more iterations than
+    // threads and in consecutive loops
+    for (const std::size_t count : {0, 1, 3, 1000}) {
+      std::vector<int> calls(count, 0);
+      pool.ParallelFor(count, [&](std::size_t i) { ++calls[i]; });
+      EXPECT_EQ(calls, std::vector<int>(count, 1));
+    }
+  }
+}
+
+TEST(UtilityTest, ThreadPoolExceptions) {
+  ThreadPool pool(4);
+
+  // The exception reaches the caller wherever it is thrown, and the loops
+  // that follow run normally
+  for (const std::size_t throwing : {0, 500, 999}) {
+    std::atomic<std::size_t> calls = 0;
+    EXPECT_THROW(pool.ParallelFor(1000,
+                                  [&](std::size_t i) {
+                                    ++calls;
+                                    if (i == throwing) {
+                                      throw std::runtime_error("iteration");
+                                    }
+                                  }),
+                 std::runtime_error);
+    EXPECT_GT(calls, 0);
+
+    std::vector<int> after(1000, 0);
+    pool.ParallelFor(after.size(), [&](std::size_t i) { ++after[i]; });
+    EXPECT_EQ(after, std::vector<int>(after.size(), 1));
+  }
+
+  // Loops run from the iterations of another loop complete
+  std::atomic<std::size_t> inner_calls = 0;
+  pool.ParallelFor(8, [&](std::size_t) {
+    pool.ParallelFor(100, [&](std::size_t) { ++inner_calls; });
+  });
+  EXPECT_EQ(inner_calls, 800);
+}
+
+TEST(UtilityTest, BatchTransformMatchesSingleValues) {
+  const transform::Affine affine{-1.5, 37.25, 400.0, 45.0f};
+  std::vector<double> values(11);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.1 * static_cast<double>(i * i) - 2;
+  }
+  values[3] = std::numeric_limits<double>::quiet_NaN();
+  values[6] = std::numeric_limits<double>::infinity();
+  const std::vector<float> float_values(values.begin(), values.end());
+
+  std::vector<float> out(values.size());
+  transform::Apply(affine, std::span<const double>(values), out.data());
+  std::vector<float> float_out(values.size());
+  transform::Apply(affine, std::span<const float>(float_values),
+                   float_out.data());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (i == 3) {
+      EXPECT_TRUE(std::isnan(out[i]));
+      continue;
+    }
+    EXPECT_EQ(out[i], transform::Apply(affine, values[i]));
+    EXPECT_EQ(float_out[i], transform::Apply(affine, float_values[i]));
+  }
+}
+
+TEST(UtilityTest, ClipPolylineToRect) {
+  const clipping::Rect rect{0, 0, 10, 10};
+  std::vector<float> out_x;
+  std::vector<float> out_y;
+  std::vector<std::size_t> sizes;
+
+  // Inside, leaving, outside and entering again
+  const std::vector<float> x{2, 5, 15, 20, 5};
+  const std::vector<float> y{2, 5, 5, 5, 5};
+  EXPECT_EQ(clipping::ClipPolyline(x.data(), y.data(), x.size(), rect, out_x,
+                                   out_y, sizes),
+            2);
+  EXPECT_THAT(sizes, ::testing::ElementsAre(3, 2));
+  EXPECT_THAT(out_x, ::testing::ElementsAre(2, 5, 10, 10, 5));
+  EXPECT_THAT(out_y, ::testing::ElementsAre(2, 5, 5, 5, 5));
+
+  // A segment between two outside points that crosses the rectangle
+  out_x.clear();
+  out_y.clear();
+  sizes.clear();
+  const std::vector<float> x_cross{-10, 20};
+  const std::vector<float> y_cross{-10, 20};
+  clipping::ClipPolyline(x_cross.data(), y_cross.data(), x_cross.size(), rect,
+                         out_x, out_y, sizes);
+  EXPECT_THAT(sizes, ::testing::ElementsAre(2));
+  EXPECT_THAT(out_x, ::testing::ElementsAre(0, 10));
+  EXPECT_THAT(out_y, ::testing::ElementsAre(0, 10));
+
+  // Hidden polylines have no pieces
+  out_x.clear();
+  out_y.clear();
+  sizes.clear();
+  const std::vector<float> x_hidden{-5, 20, 30};
+  const std::vector<float> y_hidden{20, 20, -1};
+  clipping::ClipPolyline(x_hidden.data(), y_hidden.data(), x_hidden.size(),
+                         rect, out_x, out_y, sizes);
+  EXPECT_TRUE(sizes.empty());
+  EXPECT_TRUE(out_x.empty());
+}
+
+TEST(UtilityTest, SortedWindowOfSortedArrays) {
+  constexpr Real nan = std::numeric_limits<Real>::quiet_NaN();
+  EXPECT_TRUE(reduction::IsSorted(DataArray(std::vector<Real>{})));
+  EXPECT_TRUE(reduction::IsSorted(DataArray(std::vector<Real>{1, 1, 2})));
+  EXPECT_FALSE(reduction::IsSorted(DataArray(std::vector<Real>{1, 3, 2})));
+  EXPECT_FALSE(reduction::IsSorted(DataArray(std::vector<Real>{nan, 1})));
+  EXPECT_FALSE(reduction::IsSorted(DataArray(std::vector<Real>{1, nan})));
+  EXPECT_TRUE(reduction::IsSorted(DataArray(std::vector<std::int64_t>{-3, 0})));
+
+  const DataArray values(std::vector<std::int32_t>{0, 1, 2, 2, 3, 5, 8});
+  EXPECT_EQ(reduction::SortedWindow(values, {2, 5}),
+            (std::pair<std::size_t, std::size_t>{2, 6}));
+  EXPECT_EQ(reduction::SortedWindow(values, {1.5, 4.5}),
+            (std::pair<std::size_t, std::size_t>{2, 5}));
+  EXPECT_EQ(reduction::SortedWindow(values, {6, 7}),
+            (std::pair<std::size_t, std::size_t>{6, 6}));
+
+  // Streams track the order of the points in their window
+  StreamBuffer stream(3);
+  const std::vector<Real> x{0, 2, 1, 3, 4};
+  const std::vector<Real> y(x.size(), 0);
+  stream.Append(std::span<const Real>(x).first(3),
+                std::span<const Real>(y).first(3));
+  EXPECT_FALSE(stream.IsXSorted());
+  stream.Append(std::span<const Real>(x).subspan(3),
+                std::span<const Real>(y).subspan(3));
+  EXPECT_TRUE(stream.IsXSorted());
+}
+
+TEST(UtilityTest, DensityGrid) {
+  const std::vector<float> x{0.5f, 0.9f, 1.5f, 2.5f, -0.5f, 1.0f};
+  const std::vector<float> y{0.5f, 0.1f, 1.5f, 0.5f, 0.5f, 2.0f};
+  for (const std::size_t num_threads : {1, 4}) {
+    ThreadPool pool(num_threads);
+    const density::Grid grid =
+        density::Accumulate(x.data(), y.data(), x.size(), 0, 0, 3, 2, pool);
+    EXPECT_THAT(grid.counts, ::testing::ElementsAre(2, 0, 1, 0, 1, 0));
+  }
+
+  const density::Grid grid{2, 1, {0, 3}};
+  const auto rgba = density::Colorize(grid, color_tables::VIRIDIS);
+  const Color &high = color_tables::VIRIDIS.back();
+  EXPECT_THAT(rgba, ::testing::ElementsAre(0, 0, 0, 0, high.r, high.g, high.b,
+                                           255));
+}
+
+TEST(UtilityTest, DensityGridChunks) {
+  constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+  constexpr float inf = std::numeric_limits<float>::infinity();
+
+  // Known points around a 3x2 grid at (10, 20), with points outside it and
+  // non-finite coordinates that are not counted
+  const std::vector<float> known_x{10.0f, 12.9f, 11.5f, 9.9f, 13.0f, nan,
+                                   11.0f, inf,   -inf,  10.5f};
+  const std::vector<float> known_y{20.0f, 21.9f, 20.5f, 20.0f, 21.0f, 20.0f,
+                                   nan,   21.0f, 21.0f, 22.0f};
+
+  // Enough points to be counted in several chunks
+  std::vector<float> x;
+  std::vector<float> y;
+  std::uint32_t state = 1;
+  const auto random = [&state]() {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+  };
+  for (std::size_t i = 0; i < 300000; ++i) {
+    const std::size_t k = i % known_x.size();
+    x.push_back((i % 7 == 0) ? known_x[k] : 8.0f + 6.0f * random());
+    y.push_back((i % 7 == 0) ? known_y[k] : 19.0f + 4.0f * random());
+  }
+
+  // Grid counted point by point
+  std::vector<std::uint32_t> expected(3 * 2, 0);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    if (std::isfinite(x[i]) && std::isfinite(y[i]) && (x[i] >= 10.0f) &&
+        (x[i] < 13.0f) && (y[i] >= 20.0f) && (y[i] < 22.0f)) {
+      const auto column = static_cast<std::size_t>(x[i] - 10.0f);
+      const auto row = static_cast<std::size_t>(y[i] - 20.0f);
+      ++expected[row * 3 + column];
+    }
+  }
+
+  ThreadPool single(1);
+  const density::Grid known = density::Accumulate(
+      known_x.data(), known_y.data(), known_x.size(), 10, 20, 3, 2, single);
+  EXPECT_THAT(known.counts, ::testing::ElementsAre(1, 1, 0, 0, 0, 1));
+
+  for (const std::size_t num_threads : {1, 4}) {
+    ThreadPool pool(num_threads);
+    const density::Grid grid =
+        density::Accumulate(x.data(), y.data(), x.size(), 10, 20, 3, 2, pool);
+    EXPECT_EQ(grid.width, 3);
+    EXPECT_EQ(grid.height, 2);
+    EXPECT_EQ(grid.counts, expected);
+  }
+}
+
+TEST(UtilityTest, PngDataUri) {
+  const std::vector<std::uint8_t> rgba{1, 2, 3, 4, 5, 6, 7, 8};
+  const std::string png = png::Encode(rgba.data(), 2, 1);
+  ASSERT_GT(png.size(), 8);
+  EXPECT_EQ(png.substr(1, 3), "PNG");
+  EXPECT_EQ(png.substr(png.size() - 8, 4), "IEND");
+
+  EXPECT_EQ(png::DataUri("Man"), "data:image/png;base64,TWFu");
+  EXPECT_EQ(png::DataUri("Ma"), "data:image/png;base64,TWE=");
+  EXPECT_EQ(png::DataUri("M"), "data:image/png;base64,TQ==");
+}
+
 }  // namespace plotcpp